@@ -0,0 +1,169 @@
+#include "s21_convolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_fft.h"
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+// Elements of output a single pool task should at least produce.
+const int kConvolutionParallelWork = 1 << 12;
+
+// Output rows from padded images: row i combines image rows i .. i + kr - 1
+// of every channel, shifted by each kernel column b. The weights for shift
+// b are column kc - 1 - b of the flipped kernels, gathered once so that
+// S21CombineRows reads them contiguously.
+static S21Matrix ConvolveDirect(const std::vector<S21Matrix>& images,
+                                const std::vector<S21Matrix>& kernels,
+                                int rows, int cols) {
+  size_t channels = images.size();
+  int kernel_rows = kernels[0].GetRows(), kernel_cols = kernels[0].GetCols();
+  size_t taps = channels * kernel_rows;
+  std::vector<std::vector<double>> weights(kernel_cols,
+                                           std::vector<double>(taps));
+  for (int b = 0; b < kernel_cols; ++b) {
+    for (size_t c = 0; c < channels; ++c) {
+      for (int a = 0; a < kernel_rows; ++a) {
+        weights[b][c * kernel_rows + a] =
+            kernels[c](kernel_rows - 1 - a, kernel_cols - 1 - b);
+      }
+    }
+  }
+  S21Matrix result(rows, cols, S21Uninitialized());
+  double* output = &result(0, 0);
+  S21ThreadPool::Default().ParallelFor(
+      0, rows, std::max(1, kConvolutionParallelWork / cols),
+      [&](int first, int last) {
+        std::vector<const double*> sources(taps);
+        for (int i = first; i < last; ++i) {
+          for (size_t c = 0; c < channels; ++c) {
+            for (int a = 0; a < kernel_rows; ++a) {
+              sources[c * kernel_rows + a] = &images[c](i + a, 0);
+            }
+          }
+          double* out = output + (size_t)i * cols;
+          S21Scale(0.0, out, cols);
+          for (int b = 0; b < kernel_cols; ++b) {
+            S21CombineRows(1.0, weights[b].data(), sources.data(), taps, b,
+                           out, cols);
+          }
+        }
+      });
+  return result;
+}
+
+// Full linear convolution through 2D transforms of size P x Q: rows are
+// transformed, the buffer transposed and its rows transformed again, so
+// every pass runs along contiguous memory. The channel spectra products
+// are summed in the transposed layout and transformed back, and the
+// requested window is cut out of the full result.
+static S21Matrix ConvolveFft(const std::vector<S21Matrix>& images,
+                             const std::vector<S21Matrix>& kernels,
+                             int first_row, int first_col, int rows,
+                             int cols) {
+  int image_rows = images[0].GetRows(), image_cols = images[0].GetCols();
+  int kernel_rows = kernels[0].GetRows(), kernel_cols = kernels[0].GetCols();
+  size_t p = S21FftSize(image_rows + kernel_rows - 1);
+  size_t q = S21FftSize(image_cols + kernel_cols - 1);
+  auto spectrum = [p, q](const S21Matrix& matrix) {
+    std::vector<std::complex<double>> data(p * q), transposed(q * p);
+    for (int i = 0; i < matrix.GetRows(); ++i) {
+      for (int j = 0; j < matrix.GetCols(); ++j) data[i * q + j] = matrix(i, j);
+    }
+    S21FftRows(data.data(), matrix.GetRows(), q, false);
+    for (size_t i = 0; i < p; ++i) {
+      for (size_t j = 0; j < q; ++j) transposed[j * p + i] = data[i * q + j];
+    }
+    S21FftRows(transposed.data(), q, p, false);
+    return transposed;
+  };
+  std::vector<std::complex<double>> sum(q * p);
+  for (size_t c = 0; c < images.size(); ++c) {
+    std::vector<std::complex<double>> image = spectrum(images[c]);
+    std::vector<std::complex<double>> kernel = spectrum(kernels[c]);
+    for (size_t k = 0; k < q * p; ++k) sum[k] += image[k] * kernel[k];
+  }
+  S21FftRows(sum.data(), q, p, true);
+  std::vector<std::complex<double>> data(p * q);
+  for (size_t j = 0; j < q; ++j) {
+    for (size_t i = 0; i < p; ++i) data[i * q + j] = sum[j * p + i];
+  }
+  S21FftRows(data.data() + first_row * q, rows, q, true);
+  S21Matrix result(rows, cols, S21Uninitialized());
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      result(i, j) = data[(first_row + i) * q + first_col + j].real();
+    }
+  }
+  return result;
+}
+
+S21Matrix S21Convolve2D(const S21Matrix& image, const S21Matrix& kernel,
+                        S21ConvolutionMode mode,
+                        S21ConvolutionMethod method) {
+  return S21Convolve2D(std::vector<S21Matrix>{image},
+                       std::vector<S21Matrix>{kernel}, mode, method);
+}
+
+S21Matrix S21Convolve2D(const std::vector<S21Matrix>& images,
+                        const std::vector<S21Matrix>& kernels,
+                        S21ConvolutionMode mode,
+                        S21ConvolutionMethod method) {
+  if (images.empty() || images.size() != kernels.size()) {
+    throw std::invalid_argument(
+        "Incorrect input, every image channel needs one kernel");
+  }
+  int image_rows = images[0].GetRows(), image_cols = images[0].GetCols();
+  int kernel_rows = kernels[0].GetRows(), kernel_cols = kernels[0].GetCols();
+  for (size_t c = 1; c < images.size(); ++c) {
+    if (images[c].GetRows() != image_rows ||
+        images[c].GetCols() != image_cols ||
+        kernels[c].GetRows() != kernel_rows ||
+        kernels[c].GetCols() != kernel_cols) {
+      throw std::out_of_range(
+          "Incorrect input, channels should have the same size");
+    }
+  }
+  bool full = mode == S21ConvolutionMode::kFull;
+  if (!full && (kernel_rows > image_rows || kernel_cols > image_cols)) {
+    throw std::out_of_range(
+        "Incorrect input, kernel should not be larger than the image");
+  }
+  int rows = full ? image_rows + kernel_rows - 1 : image_rows - kernel_rows + 1;
+  int cols = full ? image_cols + kernel_cols - 1 : image_cols - kernel_cols + 1;
+
+  if (method == S21ConvolutionMethod::kAuto) {
+    // Multiply-adds of the direct path against about 5 log2(n) flops per
+    // element and transform, with two transforms per channel and one back.
+    double channels = images.size();
+    double direct = 2.0 * rows * cols * channels * kernel_rows * kernel_cols;
+    double size = (double)S21FftSize(image_rows + kernel_rows - 1) *
+                  S21FftSize(image_cols + kernel_cols - 1);
+    double fft = 5.0 * size * std::log2(size) * (2.0 * channels + 1.0);
+    method = fft < direct ? S21ConvolutionMethod::kFft
+                          : S21ConvolutionMethod::kDirect;
+  }
+  if (method == S21ConvolutionMethod::kFft) {
+    return ConvolveFft(images, kernels, full ? 0 : kernel_rows - 1,
+                       full ? 0 : kernel_cols - 1, rows, cols);
+  }
+  if (!full) return ConvolveDirect(images, kernels, rows, cols);
+  // Zero margins of kernel size - 1 turn the full convolution into a valid
+  // one. They grow the image by the kernel size once, not by its area.
+  std::vector<S21Matrix> padded;
+  for (const S21Matrix& image : images) {
+    S21Matrix margin(image_rows + 2 * (kernel_rows - 1),
+                     image_cols + 2 * (kernel_cols - 1));
+    for (int i = 0; i < image_rows; ++i) {
+      for (int j = 0; j < image_cols; ++j) {
+        margin(i + kernel_rows - 1, j + kernel_cols - 1) = image(i, j);
+      }
+    }
+    padded.push_back(std::move(margin));
+  }
+  return ConvolveDirect(padded, kernels, rows, cols);
+}
@@ -0,0 +1,34 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_CONVOLUTION_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_CONVOLUTION_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// 2D convolution of an image with a kernel, the kernel flipped as in the
+// mathematical definition (pass a flipped kernel for cross-correlation).
+//  kValid - only positions where the kernel lies inside the image:
+//           (rows - kernel_rows + 1) x (cols - kernel_cols + 1).
+//  kFull  - every position with any overlap, the image padded with zeros:
+//           (rows + kernel_rows - 1) x (cols + kernel_cols - 1).
+enum class S21ConvolutionMode { kValid, kFull };
+
+// kDirect is an implicit im2col: every output row combines shifted image
+// rows through the matrix product kernel, without building the expanded
+// matrix. kFft multiplies zero-padded 2D spectra. kAuto picks the one with
+// fewer estimated operations, which is the FFT for large kernels.
+enum class S21ConvolutionMethod { kAuto, kDirect, kFft };
+
+S21Matrix S21Convolve2D(
+    const S21Matrix& image, const S21Matrix& kernel,
+    S21ConvolutionMode mode = S21ConvolutionMode::kValid,
+    S21ConvolutionMethod method = S21ConvolutionMethod::kAuto);
+// Multi-channel form: the sum over channels of each image convolved with
+// its own kernel, as in one output feature of a convolutional layer.
+S21Matrix S21Convolve2D(
+    const std::vector<S21Matrix>& images,
+    const std::vector<S21Matrix>& kernels,
+    S21ConvolutionMode mode = S21ConvolutionMode::kValid,
+    S21ConvolutionMethod method = S21ConvolutionMethod::kAuto);
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_CONVOLUTION_H_
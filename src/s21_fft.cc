@@ -0,0 +1,74 @@
+#include "s21_fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+// Elements a single pool task should at least transform.
+const size_t kFftParallelWork = 1 << 14;
+
+size_t S21FftSize(size_t size) {
+  size_t result = 1;
+  while (result < size) result *= 2;
+  return result;
+}
+
+// Iterative Cooley-Tukey with the twiddles taken from one table of the n-th
+// roots of unity, computed directly rather than by repeated multiplication.
+static void Transform(std::complex<double> *data, size_t length,
+                      const std::vector<std::complex<double>> &roots,
+                      bool inverse) {
+  for (size_t i = 1, j = 0; i < length; ++i) {
+    size_t bit = length >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(data[i], data[j]);
+  }
+  for (size_t half = 1; half < length; half *= 2) {
+    size_t stride = length / (2 * half);
+    for (size_t start = 0; start < length; start += 2 * half) {
+      for (size_t k = 0; k < half; ++k) {
+        std::complex<double> root = roots[k * stride];
+        if (inverse) root = std::conj(root);
+        std::complex<double> odd = data[start + k + half] * root;
+        data[start + k + half] = data[start + k] - odd;
+        data[start + k] += odd;
+      }
+    }
+  }
+  if (inverse) {
+    double scale = 1.0 / length;
+    for (size_t i = 0; i < length; ++i) data[i] *= scale;
+  }
+}
+
+static std::vector<std::complex<double>> Roots(size_t length) {
+  if (length == 0 || (length & (length - 1)) != 0) {
+    throw std::invalid_argument("FFT length should be a power of two");
+  }
+  std::vector<std::complex<double>> roots(length / 2 + 1);
+  for (size_t k = 0; k < roots.size(); ++k) {
+    double angle = -2.0 * M_PI * k / length;
+    roots[k] = std::complex<double>(cos(angle), sin(angle));
+  }
+  return roots;
+}
+
+void S21Fft(std::vector<std::complex<double>> &data, bool inverse) {
+  Transform(data.data(), data.size(), Roots(data.size()), inverse);
+}
+
+void S21FftRows(std::complex<double> *data, size_t count, size_t length,
+                bool inverse) {
+  std::vector<std::complex<double>> roots = Roots(length);
+  S21ThreadPool::Default().ParallelFor(
+      0, (int)count, (int)std::max<size_t>(1, kFftParallelWork / length),
+      [&](int first, int last) {
+        for (size_t row = (size_t)first; row < (size_t)last; ++row) {
+          Transform(data + row * length, length, roots, inverse);
+        }
+      });
+}
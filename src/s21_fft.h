@@ -0,0 +1,21 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_FFT_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_FFT_H_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Radix-2 FFT shared by the convolution engine and the Toeplitz and
+// circulant products.
+
+// Smallest power of two that is at least `size`.
+size_t S21FftSize(size_t size);
+// In-place transform of a power-of-two length. The inverse includes the
+// 1 / n factor, so a forward and inverse pair is the identity.
+void S21Fft(std::vector<std::complex<double>>& data, bool inverse);
+// The same over `count` consecutive rows of `length` elements each, with
+// rows split over the default pool.
+void S21FftRows(std::complex<double>* data, size_t count, size_t length,
+                bool inverse);
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_FFT_H_
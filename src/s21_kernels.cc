@@ -0,0 +1,164 @@
+#include "s21_kernels.h"
+
+#include <atomic>
+#include <vector>
+
+// Elements summed directly before pairwise combination takes over, and
+// rows per partial sum in the pairwise S21CombineRows.
+const size_t kPairwiseBlock = 128;
+
+static std::atomic<S21Accumulation> accumulation(S21Accumulation::kFast);
+
+void S21SetAccumulation(S21Accumulation mode) { accumulation = mode; }
+
+S21Accumulation S21GetAccumulation() { return accumulation; }
+
+// `y == nullptr` sums x alone, so one set of loops serves S21Dot and S21Sum.
+static double FastSum(const double *x, const double *y, size_t size) {
+  double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+  size_t i = 0;
+  if (y == nullptr) {
+    for (; i + 4 <= size; i += 4) {
+      sum0 += x[i];
+      sum1 += x[i + 1];
+      sum2 += x[i + 2];
+      sum3 += x[i + 3];
+    }
+    for (; i < size; ++i) sum0 += x[i];
+  } else {
+    for (; i + 4 <= size; i += 4) {
+      sum0 += x[i] * y[i];
+      sum1 += x[i + 1] * y[i + 1];
+      sum2 += x[i + 2] * y[i + 2];
+      sum3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < size; ++i) sum0 += x[i] * y[i];
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+static double PairwiseSum(const double *x, const double *y, size_t size) {
+  if (size <= kPairwiseBlock) return FastSum(x, y, size);
+  size_t half = size / 2 / kPairwiseBlock * kPairwiseBlock;
+  if (half == 0) half = kPairwiseBlock;
+  return PairwiseSum(x, y, half) +
+         PairwiseSum(x + half, y == nullptr ? nullptr : y + half, size - half);
+}
+
+// Kahan summation over plain sums of kCompensatedBlock elements. The plain
+// sums are the vectorized fast loop and only err by a few ulps of one short
+// block, while the Kahan chain runs once per block and so stays off the
+// critical path.
+const size_t kCompensatedBlock = 32;
+
+static double CompensatedSum(const double *x, const double *y, size_t size) {
+  double total = 0.0, correction = 0.0;
+  for (size_t i = 0; i < size; i += kCompensatedBlock) {
+    size_t length =
+        size - i < kCompensatedBlock ? size - i : kCompensatedBlock;
+    double term = FastSum(x + i, y == nullptr ? nullptr : y + i, length) -
+                  correction;
+    double next = total + term;
+    correction = (next - total) - term;
+    total = next;
+  }
+  return total - correction;
+}
+
+static double Accumulate(const double *x, const double *y, size_t size) {
+  S21Accumulation mode = accumulation;
+  if (mode == S21Accumulation::kPairwise) return PairwiseSum(x, y, size);
+  if (mode == S21Accumulation::kCompensated) {
+    return CompensatedSum(x, y, size);
+  }
+  return FastSum(x, y, size);
+}
+
+double S21Dot(const double *x, const double *y, size_t size) {
+  return Accumulate(x, y, size);
+}
+
+double S21Sum(const double *x, size_t size) {
+  return Accumulate(x, nullptr, size);
+}
+
+void S21Axpy(double alpha, const double *x, double *y, size_t size) {
+  for (size_t i = 0; i < size; ++i) y[i] += alpha * x[i];
+}
+
+void S21Scale(double alpha, double *x, size_t size) {
+  if (alpha == 0.0) {
+    for (size_t i = 0; i < size; ++i) x[i] = 0.0;
+  } else if (alpha != 1.0) {
+    for (size_t i = 0; i < size; ++i) x[i] *= alpha;
+  }
+}
+
+// The accurate modes keep per-thread scratch rows, so the per-element work
+// stays a vectorizable loop across j.
+void S21CombineRows(double alpha, const double *weights,
+                    const double *const *rows, size_t count, size_t offset,
+                    double *y, size_t size) {
+  S21Accumulation mode = accumulation;
+  if (mode == S21Accumulation::kFast) {
+    for (size_t k = 0; k < count; ++k) {
+      S21Axpy(alpha * weights[k], rows[k] + offset, y, size);
+    }
+    return;
+  }
+  static thread_local std::vector<double> scratch;
+  if (mode == S21Accumulation::kPairwise) {
+    // Partial rows of blocks merged like a binary counter: after block t the
+    // stack holds one row per set bit of t, so every row is a pairwise sum
+    // of equally sized halves and at most log2(blocks) + 1 rows are live.
+    size_t depth = 1;
+    for (size_t blocks = count / kPairwiseBlock; blocks > 0; blocks /= 2) {
+      ++depth;
+    }
+    if (scratch.size() < depth * size) scratch.resize(depth * size);
+    size_t top = 0;
+    for (size_t first = 0, block = 1; first < count;
+         first += kPairwiseBlock, ++block) {
+      size_t last = first + kPairwiseBlock < count ? first + kPairwiseBlock
+                                                   : count;
+      double *partial = scratch.data() + top * size;
+      S21Scale(0.0, partial, size);
+      for (size_t k = first; k < last; ++k) {
+        S21Axpy(alpha * weights[k], rows[k] + offset, partial, size);
+      }
+      ++top;
+      for (size_t merged = block; merged % 2 == 0; merged /= 2, --top) {
+        S21Axpy(1.0, scratch.data() + (top - 1) * size,
+                scratch.data() + (top - 2) * size, size);
+      }
+    }
+    for (; top > 1; --top) {
+      S21Axpy(1.0, scratch.data() + (top - 1) * size,
+              scratch.data() + (top - 2) * size, size);
+    }
+    if (top == 1) S21Axpy(1.0, scratch.data(), y, size);
+  } else {
+    // The same blocking across rows: plain partials of kCompensatedBlock rows
+    // are added to y with Kahan, the corrections kept in a second scratch
+    // row, so most of the work is ordinary AXPY.
+    if (scratch.size() < 2 * size) scratch.resize(2 * size);
+    double *partial = scratch.data(), *carry = scratch.data() + size;
+    S21Scale(0.0, carry, size);
+    for (size_t first = 0; first < count; first += kCompensatedBlock) {
+      size_t last = first + kCompensatedBlock < count
+                        ? first + kCompensatedBlock
+                        : count;
+      S21Scale(0.0, partial, size);
+      for (size_t k = first; k < last; ++k) {
+        S21Axpy(alpha * weights[k], rows[k] + offset, partial, size);
+      }
+      for (size_t j = 0; j < size; ++j) {
+        double term = partial[j] - carry[j];
+        double next = y[j] + term;
+        carry[j] = (next - y[j]) - term;
+        y[j] = next;
+      }
+    }
+    for (size_t j = 0; j < size; ++j) y[j] -= carry[j];
+  }
+}
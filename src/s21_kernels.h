@@ -0,0 +1,34 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_KERNELS_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_KERNELS_H_
+
+#include <cstddef>
+
+// Level-1 loops over contiguous doubles shared by the vector and matrix
+// kernels. They keep several independent accumulators so the compiler can
+// keep SIMD lanes busy without depending on a particular instruction set.
+
+// How long sums are accumulated by S21Dot, S21Sum and S21CombineRows, and so
+// by MulMatrix, the GEMV kernels and the reductions built on them.
+//  kFast         - plain running sums, error grows as O(n * eps).
+//  kPairwise     - plain sums of short blocks combined pairwise, error
+//                  grows as O(log n * eps).
+//  kCompensated  - Kahan summation over plain sums of 32 elements, error
+//                  bounded by that of one short block whatever n is.
+enum class S21Accumulation { kFast, kPairwise, kCompensated };
+
+void S21SetAccumulation(S21Accumulation mode);
+S21Accumulation S21GetAccumulation();
+
+double S21Dot(const double* x, const double* y, size_t size);
+double S21Sum(const double* x, size_t size);
+// y += alpha * x
+void S21Axpy(double alpha, const double* x, double* y, size_t size);
+// x *= alpha, with alpha == 0 clearing x regardless of its contents.
+void S21Scale(double alpha, double* x, size_t size);
+// y[j] += alpha * sum over k < count of weights[k] * rows[k][offset + j] for
+// j < size: the inner loop of the row-oriented matrix products.
+void S21CombineRows(double alpha, const double* weights,
+                    const double* const* rows, size_t count, size_t offset,
+                    double* y, size_t size);
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_KERNELS_H_
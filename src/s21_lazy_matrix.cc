@@ -0,0 +1,307 @@
+#include "s21_lazy_matrix.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+// Elements of work below which a product stays on the calling thread.
+const long long kParallelWork = 1 << 15;
+
+class S21LazyMatrix::BufferPool {
+ public:
+  S21Matrix Acquire(int rows, int cols) {
+    for (size_t i = 0; i < free_.size(); ++i) {
+      if (free_[i].GetRows() == rows && free_[i].GetCols() == cols) {
+        S21Matrix result(std::move(free_[i]));
+        free_.erase(free_.begin() + i);
+        return result;
+      }
+    }
+    return S21Matrix(rows, cols, S21Uninitialized());
+  }
+  void Release(S21Matrix&& matrix) { free_.push_back(std::move(matrix)); }
+
+ private:
+  std::vector<S21Matrix> free_;
+};
+
+S21LazyMatrix::S21LazyMatrix(S21Matrix matrix) {
+  auto node = std::make_shared<Node>();
+  node->kind = Kind::kLeaf;
+  node->rows = matrix.GetRows();
+  node->cols = matrix.GetCols();
+  node->scale = 1.0;
+  node->leaf = std::make_shared<const S21Matrix>(std::move(matrix));
+  node_ = node;
+}
+
+S21LazyMatrix::S21LazyMatrix(std::shared_ptr<const Node> node)
+    : node_(std::move(node)) {}
+
+S21LazyMatrix S21LazyMatrix::operator+(const S21LazyMatrix& other) const {
+  if (GetRows() != other.GetRows() || GetCols() != other.GetCols()) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  }
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node{Kind::kSum, GetRows(), GetCols(), 1.0, node_, other.node_, {}}));
+}
+
+S21LazyMatrix S21LazyMatrix::operator-(const S21LazyMatrix& other) const {
+  if (GetRows() != other.GetRows() || GetCols() != other.GetCols()) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  }
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node{Kind::kSum, GetRows(), GetCols(), -1.0, node_, other.node_, {}}));
+}
+
+S21LazyMatrix S21LazyMatrix::operator*(const S21LazyMatrix& other) const {
+  if (GetCols() != other.GetRows()) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node{Kind::kProduct, GetRows(), other.GetCols(), 1.0, node_,
+           other.node_, {}}));
+}
+
+S21LazyMatrix S21LazyMatrix::operator*(const double num) const {
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node{Kind::kScale, GetRows(), GetCols(), num, node_, nullptr, {}}));
+}
+
+S21LazyMatrix operator*(double num, const S21LazyMatrix& matrix) {
+  return matrix * num;
+}
+
+S21LazyMatrix S21LazyMatrix::Transpose() const {
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node{Kind::kTranspose, GetCols(), GetRows(), 1.0, node_, nullptr, {}}));
+}
+
+S21Matrix S21LazyMatrix::Evaluate() const {
+  BufferPool pool;
+  Shared shared;
+  CountUses(*node_, shared.uses);
+  return Run(Normalize(*node_, false, shared, pool), pool);
+}
+
+void S21LazyMatrix::CountUses(const Node& node,
+                              std::unordered_map<const Node*, int>& uses) {
+  if (node.kind == Kind::kLeaf || uses[&node]++ > 0) return;
+  CountUses(*node.left, uses);
+  if (node.right != nullptr) CountUses(*node.right, uses);
+}
+
+S21LazyMatrix::Combination S21LazyMatrix::Normalize(const Node& node,
+                                                    bool transposed,
+                                                    Shared& shared,
+                                                    BufferPool& pool) {
+  if (node.kind == Kind::kLeaf || shared.uses[&node] < 2) {
+    return Expand(node, transposed, shared, pool);
+  }
+  auto found = shared.values.find(&node);
+  if (found == shared.values.end()) {
+    S21Matrix value = Run(Expand(node, false, shared, pool), pool);
+    found = shared.values.emplace(&node, std::move(value)).first;
+  }
+  Combination result;
+  result.rows = transposed ? node.cols : node.rows;
+  result.cols = transposed ? node.rows : node.cols;
+  result.terms.push_back(Term{
+      1.0, {Factor{&found->second, transposed, nullptr, result.rows,
+                   result.cols}}});
+  return result;
+}
+
+// Rewrites the graph into a sum of scaled product chains. Transposes are
+// pushed to the leaves using (A * B)^T = B^T * A^T, so they only survive as
+// a flag on each operand. A product with a multi-term operand keeps that
+// operand as one nested factor instead of distributing over it. Shared
+// nodes stop the rewrite and stand in as leaves holding their value.
+S21LazyMatrix::Combination S21LazyMatrix::Expand(const Node& node,
+                                                 bool transposed,
+                                                 Shared& shared,
+                                                 BufferPool& pool) {
+  Combination result;
+  result.rows = transposed ? node.cols : node.rows;
+  result.cols = transposed ? node.rows : node.cols;
+  if (node.kind == Kind::kLeaf) {
+    result.terms.push_back(Term{
+        1.0,
+        {Factor{node.leaf.get(), transposed, nullptr, result.rows,
+                result.cols}}});
+  } else if (node.kind == Kind::kTranspose) {
+    result = Normalize(*node.left, !transposed, shared, pool);
+  } else if (node.kind == Kind::kScale) {
+    result = Normalize(*node.left, transposed, shared, pool);
+    for (Term& term : result.terms) term.scale *= node.scale;
+  } else if (node.kind == Kind::kSum) {
+    result = Normalize(*node.left, transposed, shared, pool);
+    Combination right = Normalize(*node.right, transposed, shared, pool);
+    for (Term& term : right.terms) {
+      term.scale *= node.scale;
+      result.terms.push_back(std::move(term));
+    }
+  } else {
+    const Node& first = transposed ? *node.right : *node.left;
+    const Node& second = transposed ? *node.left : *node.right;
+    Term product{1.0, {}};
+    for (const Node* side : {&first, &second}) {
+      Combination part = Normalize(*side, transposed, shared, pool);
+      if (part.terms.size() == 1) {
+        product.scale *= part.terms[0].scale;
+        for (Factor& factor : part.terms[0].chain) {
+          product.chain.push_back(std::move(factor));
+        }
+      } else {
+        int rows = part.rows, cols = part.cols;
+        product.chain.push_back(Factor{
+            nullptr, false, std::make_shared<Combination>(std::move(part)),
+            rows, cols});
+      }
+    }
+    result.terms.push_back(std::move(product));
+  }
+  return result;
+}
+
+// Every term becomes either a view of a leaf or a product buffer, then one
+// pass over the result adds them all up with their scales.
+S21Matrix S21LazyMatrix::Run(const Combination& combination,
+                             BufferPool& pool) {
+  if (combination.terms.size() == 1 && combination.terms[0].scale == 1.0 &&
+      combination.terms[0].chain.size() > 1) {
+    return RunChain(combination.terms[0], pool);
+  }
+  std::vector<S21Matrix> buffers;
+  std::vector<const S21Matrix*> views;
+  std::vector<bool> flags;
+  buffers.reserve(combination.terms.size());
+  for (const Term& term : combination.terms) {
+    const Factor& factor = term.chain[0];
+    if (term.chain.size() == 1 && factor.leaf != nullptr) {
+      views.push_back(factor.leaf);
+      flags.push_back(factor.transposed);
+    } else {
+      buffers.push_back(term.chain.size() == 1 ? Run(*factor.nested, pool)
+                                               : RunChain(term, pool));
+      views.push_back(&buffers.back());
+      flags.push_back(false);
+    }
+  }
+
+  S21Matrix result = pool.Acquire(combination.rows, combination.cols);
+  for (size_t i = 0; i < (size_t)result.rows_; ++i) {
+    for (size_t j = 0; j < (size_t)result.cols_; ++j) {
+      double sum = 0.0;
+      for (size_t t = 0; t < views.size(); ++t) {
+        sum += combination.terms[t].scale *
+               (flags[t] ? views[t]->matrix_[j][i] : views[t]->matrix_[i][j]);
+      }
+      result.matrix_[i][j] = sum;
+    }
+  }
+  for (S21Matrix& buffer : buffers) {
+    pool.Release(std::move(buffer));
+  }
+  return result;
+}
+
+// Classic matrix-chain dynamic programming over the operand sizes, then the
+// chosen parenthesization is executed with dead intermediates going back to
+// the pool.
+S21Matrix S21LazyMatrix::RunChain(const Term& term, BufferPool& pool) {
+  struct Operand {
+    const S21Matrix* view;
+    bool transposed;
+    S21Matrix owned;
+    bool is_owned;
+    const S21Matrix& Get() const { return is_owned ? owned : *view; }
+  };
+  size_t count = term.chain.size();
+  std::vector<Operand> operands;
+  std::vector<long long> dims(count + 1);
+  for (size_t i = 0; i < count; ++i) {
+    const Factor& factor = term.chain[i];
+    if (factor.leaf != nullptr) {
+      operands.push_back(Operand{factor.leaf, factor.transposed, {}, false});
+    } else {
+      operands.push_back(
+          Operand{nullptr, false, Run(*factor.nested, pool), true});
+    }
+    dims[i] = factor.rows;
+    dims[i + 1] = factor.cols;
+  }
+
+  std::vector<std::vector<long long>> cost(count,
+                                           std::vector<long long>(count, 0));
+  std::vector<std::vector<size_t>> split(count, std::vector<size_t>(count, 0));
+  for (size_t length = 2; length <= count; ++length) {
+    for (size_t i = 0; i + length <= count; ++i) {
+      size_t j = i + length - 1;
+      cost[i][j] = -1;
+      for (size_t k = i; k < j; ++k) {
+        long long candidate = cost[i][k] + cost[k + 1][j] +
+                              dims[i] * dims[k + 1] * dims[j + 1];
+        if (cost[i][j] < 0 || candidate < cost[i][j]) {
+          cost[i][j] = candidate;
+          split[i][j] = k;
+        }
+      }
+    }
+  }
+
+  std::function<Operand(size_t, size_t)> compute = [&](size_t i, size_t j) {
+    if (i == j) return std::move(operands[i]);
+    Operand left = compute(i, split[i][j]);
+    Operand right = compute(split[i][j] + 1, j);
+    S21Matrix result = pool.Acquire(dims[i], dims[j + 1]);
+    Multiply(left.Get(), left.transposed, right.Get(), right.transposed,
+             result);
+    if (left.is_owned) pool.Release(std::move(left.owned));
+    if (right.is_owned) pool.Release(std::move(right.owned));
+    return Operand{nullptr, false, std::move(result), true};
+  };
+  return std::move(compute(0, count - 1).owned);
+}
+
+// One result row per step, as in S21Matrix::Multiply. A transposed left
+// operand contributes a gathered column as the row weights; a transposed
+// right operand is already stored by result column, so each element is a
+// row-by-row dot product.
+void S21LazyMatrix::Multiply(const S21Matrix& left, bool left_transposed,
+                             const S21Matrix& right, bool right_transposed,
+                             S21Matrix& result) {
+  size_t inner = (size_t)(left_transposed ? left.rows_ : left.cols_);
+  size_t cols = (size_t)result.cols_;
+  S21ThreadPool::Default().ParallelFor(
+      0, result.rows_,
+      std::max(1, (int)(kParallelWork / ((long long)inner * cols))),
+      [&](int first, int last) {
+        std::vector<double> column(left_transposed ? inner : 0);
+        for (size_t i = (size_t)first; i < (size_t)last; ++i) {
+          const double* weights = column.data();
+          if (left_transposed) {
+            for (size_t k = 0; k < inner; ++k) column[k] = left.matrix_[k][i];
+          } else {
+            weights = left.matrix_[i];
+          }
+          double* out = result.matrix_[i];
+          if (right_transposed) {
+            for (size_t j = 0; j < cols; ++j) {
+              out[j] = S21Dot(weights, right.matrix_[j], inner);
+            }
+          } else {
+            S21Scale(0.0, out, cols);
+            S21CombineRows(1.0, weights, right.matrix_, inner, 0, out, cols);
+          }
+        }
+      });
+}
@@ -0,0 +1,82 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_LAZY_MATRIX_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_LAZY_MATRIX_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Deferred matrix expression. Operators only record a graph node and check
+// the operand sizes; Evaluate() rewrites the whole graph before running it:
+// transposes are pushed down to the operands and absorbed by the products
+// that use them, consecutive products are reordered for the fewest
+// multiplications, sums and scalings are computed in a single fused pass and
+// intermediate buffers are reused once they are dead. Products run on the
+// same parallel kernel as S21Matrix::MulMatrix.
+class S21LazyMatrix {
+ public:
+  explicit S21LazyMatrix(S21Matrix matrix);
+
+  S21LazyMatrix operator+(const S21LazyMatrix& other) const;
+  S21LazyMatrix operator-(const S21LazyMatrix& other) const;
+  S21LazyMatrix operator*(const S21LazyMatrix& other) const;
+  S21LazyMatrix operator*(const double num) const;
+  friend S21LazyMatrix operator*(double num, const S21LazyMatrix& matrix);
+  S21LazyMatrix Transpose() const;
+
+  int GetRows() const { return node_->rows; };
+  int GetCols() const { return node_->cols; };
+  S21Matrix Evaluate() const;
+
+ private:
+  enum class Kind { kLeaf, kSum, kProduct, kScale, kTranspose };
+  struct Node {
+    Kind kind;
+    int rows, cols;
+    double scale;
+    std::shared_ptr<const Node> left, right;
+    std::shared_ptr<const S21Matrix> leaf;
+  };
+
+  // Evaluate-time normal form: a sum of scaled products.
+  struct Combination;
+  struct Factor {
+    const S21Matrix* leaf;
+    bool transposed;
+    std::shared_ptr<Combination> nested;
+    int rows, cols;
+  };
+  struct Term {
+    double scale;
+    std::vector<Factor> chain;
+  };
+  struct Combination {
+    int rows, cols;
+    std::vector<Term> terms;
+  };
+  class BufferPool;
+  // Inner nodes reached along more than one path. Each is evaluated once
+  // and then read like a leaf, so reuse such as x = x * x stays linear.
+  struct Shared {
+    std::unordered_map<const Node*, int> uses;
+    std::unordered_map<const Node*, S21Matrix> values;
+  };
+
+  std::shared_ptr<const Node> node_;
+
+  explicit S21LazyMatrix(std::shared_ptr<const Node> node);
+  static void CountUses(const Node& node,
+                        std::unordered_map<const Node*, int>& uses);
+  static Combination Normalize(const Node& node, bool transposed,
+                               Shared& shared, BufferPool& pool);
+  static Combination Expand(const Node& node, bool transposed, Shared& shared,
+                            BufferPool& pool);
+  static S21Matrix Run(const Combination& combination, BufferPool& pool);
+  static S21Matrix RunChain(const Term& term, BufferPool& pool);
+  static void Multiply(const S21Matrix& left, bool left_transposed,
+                       const S21Matrix& right, bool right_transposed,
+                       S21Matrix& result);
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_LAZY_MATRIX_H_
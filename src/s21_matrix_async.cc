@@ -0,0 +1,211 @@
+#include "s21_matrix_async.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+void S21AsyncMatrix::State::OnReady(std::function<void()> callback) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!done) {
+      continuations.push_back(std::move(callback));
+      return;
+    }
+  }
+  callback();
+}
+
+void S21AsyncMatrix::State::Finish() {
+  std::vector<std::function<void()>> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    ready.swap(continuations);
+  }
+  for (std::function<void()> &callback : ready) {
+    callback();
+  }
+}
+
+S21AsyncMatrix::S21AsyncMatrix(S21ThreadPool &pool)
+    : state_(std::make_shared<State>()), pool_(&pool) {
+  state_->future = state_->promise.get_future().share();
+}
+
+S21AsyncMatrix::S21AsyncMatrix(S21Matrix matrix, S21ThreadPool &pool)
+    : S21AsyncMatrix(pool) {
+  state_->promise.set_value(std::move(matrix));
+  state_->Finish();
+}
+
+// Queues `compute` once every dependency is ready. The last dependency to
+// finish submits the task, so no worker ever waits on another one.
+S21AsyncMatrix S21AsyncMatrix::Schedule(
+    S21ThreadPool &pool, std::vector<std::shared_ptr<State>> deps,
+    std::function<S21Matrix(const std::vector<const S21Matrix *> &)>
+        compute) {
+  S21AsyncMatrix result(pool);
+  std::shared_ptr<State> state = result.state_;
+  S21ThreadPool *executor = &pool;
+  auto run = [state, deps, compute]() {
+    try {
+      if (state->cancelled) {
+        throw std::runtime_error("Operation was cancelled");
+      }
+      std::vector<const S21Matrix *> args;
+      for (const std::shared_ptr<State> &dep : deps) {
+        args.push_back(&dep->future.get());
+      }
+      state->promise.set_value(compute(args));
+    } catch (...) {
+      state->promise.set_exception(std::current_exception());
+    }
+    state->Finish();
+  };
+  auto start = [executor, run]() { executor->Submit(run); };
+  if (deps.empty()) {
+    start();
+  } else {
+    auto pending = std::make_shared<std::atomic<int>>((int)deps.size());
+    for (const std::shared_ptr<State> &dep : deps) {
+      dep->OnReady([pending, start]() {
+        if (pending->fetch_sub(1) == 1) start();
+      });
+    }
+  }
+  return result;
+}
+
+S21AsyncMatrix S21AsyncMatrix::Launch(std::function<S21Matrix()> producer,
+                                      S21ThreadPool &pool) {
+  return Schedule(pool, {},
+                  [producer](const std::vector<const S21Matrix *> &) {
+                    return producer();
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::Then(
+    std::function<S21Matrix(const S21Matrix &)> step) const {
+  return Schedule(*pool_, {state_},
+                  [step](const std::vector<const S21Matrix *> &args) {
+                    return step(*args[0]);
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::SumMatrix(const S21AsyncMatrix &other) const {
+  return Schedule(*pool_, {state_, other.state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return *args[0] + *args[1];
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::SubMatrix(const S21AsyncMatrix &other) const {
+  return Schedule(*pool_, {state_, other.state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return *args[0] - *args[1];
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::MulNumber(const double num) const {
+  return Schedule(*pool_, {state_},
+                  [num](const std::vector<const S21Matrix *> &args) {
+                    return *args[0] * num;
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::MulMatrix(const S21AsyncMatrix &other) const {
+  return Schedule(*pool_, {state_, other.state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return *args[0] * *args[1];
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::Transpose() const {
+  return Schedule(*pool_, {state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return args[0]->Transpose();
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::CalcComplements() const {
+  return Schedule(*pool_, {state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return args[0]->CalcComplements();
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::InverseMatrix() const {
+  return Schedule(*pool_, {state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return args[0]->InverseMatrix();
+                  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::Solve(const S21AsyncMatrix &rhs) const {
+  return Schedule(*pool_, {state_, rhs.state_},
+                  [](const std::vector<const S21Matrix *> &args) {
+                    return args[0]->Solve(*args[1]);
+                  });
+}
+
+// Same value as S21Matrix::Determinant() up to rounding, but always through
+// the LU so that a cancelled request stops between elimination steps.
+static double CancellableDeterminant(const S21Matrix &matrix,
+                                     const std::atomic<bool> &cancelled) {
+  std::vector<int> row_perm, col_perm;
+  int sign = 1, rank = 0;
+  S21Matrix lu = matrix.DecomposeLU(row_perm, col_perm, sign, rank,
+                                    &cancelled);
+  if (rank < matrix.GetRows()) return 0.0;
+  double result = sign;
+  for (int i = 0; i < matrix.GetRows(); ++i) result *= lu(i, i);
+  return result;
+}
+
+S21AsyncValue S21AsyncMatrix::Determinant() const {
+  auto promise = std::make_shared<std::promise<double>>();
+  auto cancelled = std::make_shared<std::atomic<bool>>(false);
+  S21AsyncValue result(promise->get_future().share(), cancelled);
+  std::shared_ptr<State> state = state_;
+  S21ThreadPool *executor = pool_;
+  state_->OnReady([state, promise, cancelled, executor]() {
+    executor->Submit([state, promise, cancelled]() {
+      try {
+        if (*cancelled) throw std::runtime_error("Operation was cancelled");
+        promise->set_value(
+            CancellableDeterminant(state->future.get(), *cancelled));
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+    });
+  });
+  return result;
+}
+
+S21Matrix S21AsyncMatrix::Get() const { return state_->future.get(); }
+
+std::shared_future<S21Matrix> S21AsyncMatrix::GetFuture() const {
+  return state_->future;
+}
+
+bool S21AsyncMatrix::IsReady() const {
+  return state_->future.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+void S21AsyncMatrix::Cancel() { state_->cancelled = true; }
+
+S21AsyncValue::S21AsyncValue(std::shared_future<double> future,
+                             std::shared_ptr<std::atomic<bool>> cancelled)
+    : future_(std::move(future)), cancelled_(std::move(cancelled)) {}
+
+double S21AsyncValue::Get() const { return future_.get(); }
+
+std::shared_future<double> S21AsyncValue::GetFuture() const { return future_; }
+
+bool S21AsyncValue::IsReady() const {
+  return future_.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+void S21AsyncValue::Cancel() { *cancelled_ = true; }
@@ -0,0 +1,87 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_ASYNC_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_ASYNC_H_
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+// Handle to a number that is being computed on a thread pool, with its own
+// cancellation: Cancel() makes Get() throw std::runtime_error unless the
+// value is already there, and stops a determinant between elimination
+// steps.
+class S21AsyncValue {
+ public:
+  double Get() const;
+  std::shared_future<double> GetFuture() const;
+  bool IsReady() const;
+  void Cancel();
+
+ private:
+  friend class S21AsyncMatrix;
+  std::shared_future<double> future_;
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+
+  S21AsyncValue(std::shared_future<double> future,
+                std::shared_ptr<std::atomic<bool>> cancelled);
+};
+
+// Handle to a matrix that is being computed on a thread pool. Operations on
+// handles return new handles at once: the work is queued when all operands
+// are ready, so chains run without waiting in between. Errors, including
+// cancellation, reach every dependent handle and are rethrown by Get().
+// Get() must not be called from a task of the same pool.
+class S21AsyncMatrix {
+ public:
+  explicit S21AsyncMatrix(S21Matrix matrix,
+                          S21ThreadPool& pool = S21ThreadPool::Default());
+
+  static S21AsyncMatrix Launch(std::function<S21Matrix()> producer,
+                               S21ThreadPool& pool = S21ThreadPool::Default());
+  S21AsyncMatrix Then(std::function<S21Matrix(const S21Matrix&)> step) const;
+
+  S21AsyncMatrix SumMatrix(const S21AsyncMatrix& other) const;
+  S21AsyncMatrix SubMatrix(const S21AsyncMatrix& other) const;
+  S21AsyncMatrix MulNumber(const double num) const;
+  S21AsyncMatrix MulMatrix(const S21AsyncMatrix& other) const;
+  S21AsyncMatrix Transpose() const;
+  S21AsyncMatrix CalcComplements() const;
+  S21AsyncMatrix InverseMatrix() const;
+  S21AsyncMatrix Solve(const S21AsyncMatrix& rhs) const;
+  S21AsyncValue Determinant() const;
+
+  S21Matrix Get() const;
+  std::shared_future<S21Matrix> GetFuture() const;
+  bool IsReady() const;
+  // Cancels the operation that produces this handle: if it has not started
+  // yet, it fails with std::runtime_error; once running, it finishes
+  // normally.
+  void Cancel();
+
+ private:
+  struct State {
+    std::promise<S21Matrix> promise;
+    std::shared_future<S21Matrix> future;
+    std::mutex mutex;
+    bool done = false;
+    std::vector<std::function<void()>> continuations;
+    std::atomic<bool> cancelled{false};
+    void OnReady(std::function<void()> callback);
+    void Finish();
+  };
+
+  std::shared_ptr<State> state_;
+  S21ThreadPool* pool_;
+
+  explicit S21AsyncMatrix(S21ThreadPool& pool);
+  static S21AsyncMatrix Schedule(
+      S21ThreadPool& pool, std::vector<std::shared_ptr<State>> deps,
+      std::function<S21Matrix(const std::vector<const S21Matrix*>&)> compute);
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_ASYNC_H_
@@ -0,0 +1,587 @@
+#include "s21_matrix_decomposition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+// Smallest number of rows handed to one pool task.
+const int kParallelGrain = 32;
+
+// Householder reduction to tridiagonal form, A = Q * T * Q^T. Each step
+// reflects the trailing block with the symmetric rank-2 update
+// A -= 2 * (v * q^T + q * v^T), whose rows are spread over the pool.
+static void Tridiagonalize(std::vector<double> &a, int n,
+                           std::vector<double> &diagonal,
+                           std::vector<double> &off_diagonal,
+                           std::vector<double> &q) {
+  S21ThreadPool &pool = S21ThreadPool::Default();
+  std::vector<std::vector<double>> reflectors(std::max(0, n - 2));
+  for (int k = 0; k + 2 < n; ++k) {
+    int size = n - k - 1;
+    std::vector<double> v(size);
+    double norm = 0.0;
+    for (int i = 0; i < size; ++i) {
+      v[i] = a[(size_t)(k + 1 + i) * n + k];
+      norm += v[i] * v[i];
+    }
+    norm = sqrt(norm);
+    if (norm == 0.0) continue;
+    double alpha = v[0] > 0 ? -norm : norm;
+    v[0] -= alpha;
+    double v_norm = 0.0;
+    for (double value : v) v_norm += value * value;
+    v_norm = sqrt(v_norm);
+    for (double &value : v) value /= v_norm;
+
+    std::vector<double> p(size);
+    pool.ParallelFor(0, size, kParallelGrain, [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+        const double *row = &a[(size_t)(k + 1 + i) * n + k + 1];
+        double sum = 0.0;
+        for (int j = 0; j < size; ++j) sum += row[j] * v[j];
+        p[i] = sum;
+      }
+    });
+    double vp = 0.0;
+    for (int i = 0; i < size; ++i) vp += v[i] * p[i];
+    for (int i = 0; i < size; ++i) p[i] -= vp * v[i];
+    pool.ParallelFor(0, size, kParallelGrain, [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+        double *row = &a[(size_t)(k + 1 + i) * n + k + 1];
+        for (int j = 0; j < size; ++j) {
+          row[j] -= 2.0 * (v[i] * p[j] + p[i] * v[j]);
+        }
+      }
+    });
+    a[(size_t)(k + 1) * n + k] = a[(size_t)k * n + k + 1] = alpha;
+    for (int i = 1; i < size; ++i) {
+      a[(size_t)(k + 1 + i) * n + k] = a[(size_t)k * n + k + 1 + i] = 0.0;
+    }
+    reflectors[k] = std::move(v);
+  }
+
+  diagonal.assign(n, 0.0);
+  off_diagonal.assign(n, 0.0);
+  for (int i = 0; i < n; ++i) {
+    diagonal[i] = a[(size_t)i * n + i];
+    if (i + 1 < n) off_diagonal[i] = a[(size_t)i * n + i + 1];
+  }
+
+  q.assign((size_t)n * n, 0.0);
+  for (int i = 0; i < n; ++i) q[(size_t)i * n + i] = 1.0;
+  for (int k = n - 3; k >= 0; --k) {
+    const std::vector<double> &v = reflectors[k];
+    if (v.empty()) continue;
+    int size = n - k - 1;
+    std::vector<double> r(n, 0.0);
+    for (int i = 0; i < size; ++i) {
+      const double *row = &q[(size_t)(k + 1 + i) * n];
+      for (int j = 0; j < n; ++j) r[j] += v[i] * row[j];
+    }
+    pool.ParallelFor(0, size, kParallelGrain, [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+        double *row = &q[(size_t)(k + 1 + i) * n];
+        for (int j = 0; j < n; ++j) row[j] -= 2.0 * v[i] * r[j];
+      }
+    });
+  }
+}
+
+// Implicit QL iteration with Wilkinson shifts on the tridiagonal matrix
+// (after EISPACK tql2), rotating the columns of `z` along.
+static void TridiagonalQL(std::vector<double> &d, std::vector<double> &e,
+                          std::vector<double> &z, int n) {
+  double shift = 0.0, scale = 0.0;
+  for (int l = 0; l < n; ++l) {
+    scale = std::max(scale, fabs(d[l]) + fabs(e[l]));
+    int m = l;
+    while (m < n - 1 && fabs(e[m]) > DBL_EPSILON * scale) ++m;
+    int iterations = 0;
+    while (m > l && fabs(e[l]) > DBL_EPSILON * scale) {
+      if (++iterations > 60) {
+        throw std::runtime_error("Eigenvalues did not converge");
+      }
+      double g = d[l];
+      double p = (d[l + 1] - g) / (2.0 * e[l]);
+      double r = hypot(p, 1.0);
+      if (p < 0) r = -r;
+      d[l] = e[l] / (p + r);
+      d[l + 1] = e[l] * (p + r);
+      double dl1 = d[l + 1];
+      double h = g - d[l];
+      for (int i = l + 2; i < n; ++i) d[i] -= h;
+      shift += h;
+
+      p = d[m];
+      double c = 1.0, c2 = c, c3 = c, el1 = e[l + 1], s = 0.0, s2 = 0.0;
+      for (int i = m - 1; i >= l; --i) {
+        c3 = c2;
+        c2 = c;
+        s2 = s;
+        g = c * e[i];
+        h = c * p;
+        r = hypot(p, e[i]);
+        e[i + 1] = s * r;
+        s = e[i] / r;
+        c = p / r;
+        p = c * d[i] - s * g;
+        d[i + 1] = h + s * (c * g + s * d[i]);
+        for (int k = 0; k < n; ++k) {
+          double *row = &z[(size_t)k * n];
+          double t = row[i + 1];
+          row[i + 1] = s * row[i] + c * t;
+          row[i] = c * row[i] - s * t;
+        }
+      }
+      p = -s * s2 * c3 * el1 * e[l] / dl1;
+      e[l] = s * p;
+      d[l] = c * p;
+    }
+    d[l] += shift;
+    e[l] = 0.0;
+  }
+}
+
+S21SymmetricEigen S21EigenSymmetric(const S21Matrix &matrix) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  int n = matrix.GetRows();
+  std::vector<double> a((size_t)n * n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      if (fabs(matrix(i, j) - matrix(j, i)) > eps) {
+        throw std::invalid_argument("The matrix is not symmetric");
+      }
+      a[(size_t)i * n + j] = matrix(i, j);
+    }
+  }
+  std::vector<double> d, e, z;
+  Tridiagonalize(a, n, d, e, z);
+  TridiagonalQL(d, e, z, n);
+
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&d](int x, int y) { return d[x] < d[y]; });
+  S21SymmetricEigen result{std::vector<double>(n), S21Matrix(n, n)};
+  for (int j = 0; j < n; ++j) {
+    result.values[j] = d[order[j]];
+    for (int i = 0; i < n; ++i) {
+      result.vectors(i, j) = z[(size_t)i * n + order[j]];
+    }
+  }
+  return result;
+}
+
+// One-sided Jacobi on the columns of a tall matrix. Columns are paired in
+// round-robin order, so the n / 2 rotations of a round touch disjoint
+// columns and run on the pool in parallel.
+S21SingularValues S21SingularValueDecomposition(const S21Matrix &matrix) {
+  bool wide = matrix.GetRows() < matrix.GetCols();
+  int m = wide ? matrix.GetCols() : matrix.GetRows();
+  int n = wide ? matrix.GetRows() : matrix.GetCols();
+  // Column j of the working matrix is kept contiguous as w[j * m ...].
+  std::vector<double> w((size_t)n * m), v((size_t)n * n, 0.0);
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < m; ++i) {
+      w[(size_t)j * m + i] = wide ? matrix(j, i) : matrix(i, j);
+    }
+    v[(size_t)j * n + j] = 1.0;
+  }
+
+  S21ThreadPool &pool = S21ThreadPool::Default();
+  int slots = n + n % 2;
+  std::vector<int> ring(slots);
+  std::iota(ring.begin(), ring.end(), 0);
+  bool rotated = true;
+  for (int sweep = 0; sweep < 60 && rotated; ++sweep) {
+    std::atomic<bool> any(false);
+    for (int round = 0; round + 1 < slots || round == 0; ++round) {
+      pool.ParallelFor(
+          0, slots / 2, std::max(1, kParallelGrain * 64 / m),
+          [&](int first, int last) {
+            for (int pair = first; pair < last; ++pair) {
+              int p = ring[pair], q = ring[slots - 1 - pair];
+              if (p >= n || q >= n) continue;
+              if (p > q) std::swap(p, q);
+              double *wp = &w[(size_t)p * m], *wq = &w[(size_t)q * m];
+              double alpha = 0.0, beta = 0.0, gamma = 0.0;
+              for (int i = 0; i < m; ++i) {
+                alpha += wp[i] * wp[i];
+                beta += wq[i] * wq[i];
+                gamma += wp[i] * wq[i];
+              }
+              if (fabs(gamma) <= DBL_EPSILON * sqrt(alpha * beta) ||
+                  gamma == 0.0) {
+                continue;
+              }
+              any = true;
+              double zeta = (beta - alpha) / (2.0 * gamma);
+              double t = (zeta >= 0 ? 1.0 : -1.0) /
+                         (fabs(zeta) + sqrt(1.0 + zeta * zeta));
+              double c = 1.0 / sqrt(1.0 + t * t), s = c * t;
+              for (int i = 0; i < m; ++i) {
+                double x = wp[i], y = wq[i];
+                wp[i] = c * x - s * y;
+                wq[i] = s * x + c * y;
+              }
+              double *vp = &v[(size_t)p * n], *vq = &v[(size_t)q * n];
+              for (int i = 0; i < n; ++i) {
+                double x = vp[i], y = vq[i];
+                vp[i] = c * x - s * y;
+                vq[i] = s * x + c * y;
+              }
+            }
+          });
+      std::rotate(ring.begin() + 1, ring.end() - 1, ring.end());
+    }
+    rotated = any;
+  }
+
+  std::vector<double> norms(n);
+  for (int j = 0; j < n; ++j) {
+    double sum = 0.0;
+    for (int i = 0; i < m; ++i) {
+      sum += w[(size_t)j * m + i] * w[(size_t)j * m + i];
+    }
+    norms[j] = sqrt(sum);
+  }
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&norms](int x, int y) { return norms[x] > norms[y]; });
+
+  S21Matrix left(m, n), right(n, n);
+  std::vector<double> singular(n);
+  for (int k = 0; k < n; ++k) {
+    int j = order[k];
+    singular[k] = norms[j];
+    for (int i = 0; i < m; ++i) {
+      left(i, k) = norms[j] > 0.0 ? w[(size_t)j * m + i] / norms[j] : 0.0;
+    }
+    for (int i = 0; i < n; ++i) {
+      right(i, k) = v[(size_t)j * n + i];
+    }
+  }
+  if (wide) {
+    return S21SingularValues{right, singular, left};
+  }
+  return S21SingularValues{left, singular, right};
+}
+
+// Columns per Householder panel of the blocked QR.
+const int kQRBlock = 32;
+
+// Applies the block reflector I - Y * T * Y^T of the panel starting at
+// (first, first), or its transpose, to the c_cols columns of `c`. Y is read
+// from below the diagonal of `a` with an implicit unit diagonal. Column
+// chunks of `c` are independent and run on the pool.
+static void ApplyBlockReflector(const std::vector<double> &a, int m, int n,
+                                int first, int width,
+                                const std::vector<double> &t, double *c,
+                                int c_stride, int c_cols, bool transpose) {
+  auto y = [&](int row, int p) {
+    int offset = row - first;
+    if (offset == p) return 1.0;
+    return offset > p ? a[(size_t)row * n + first + p] : 0.0;
+  };
+  S21ThreadPool::Default().ParallelFor(
+      0, c_cols, kParallelGrain, [&](int begin, int end) {
+        int cols = end - begin;
+        std::vector<double> w((size_t)width * cols, 0.0);
+        for (int row = first; row < m; ++row) {
+          const double *c_row = c + (size_t)row * c_stride + begin;
+          for (int p = 0; p < width && p <= row - first; ++p) {
+            double factor = y(row, p);
+            for (int j = 0; j < cols; ++j) {
+              w[p * cols + j] += factor * c_row[j];
+            }
+          }
+        }
+        std::vector<double> tw((size_t)width * cols, 0.0);
+        for (int p = 0; p < width; ++p) {
+          for (int q = 0; q < width; ++q) {
+            double factor = transpose ? t[q * width + p] : t[p * width + q];
+            if (factor == 0.0) continue;
+            for (int j = 0; j < cols; ++j) {
+              tw[p * cols + j] += factor * w[q * cols + j];
+            }
+          }
+        }
+        for (int row = first; row < m; ++row) {
+          double *c_row = c + (size_t)row * c_stride + begin;
+          for (int p = 0; p < width && p <= row - first; ++p) {
+            double factor = y(row, p);
+            for (int j = 0; j < cols; ++j) {
+              c_row[j] -= factor * tw[p * cols + j];
+            }
+          }
+        }
+      });
+}
+
+// Blocked Householder QR in place (LAPACK geqrf layout): R on and above the
+// diagonal, reflectors below it, H = I - tau * v * v^T. Each panel is
+// factored column by column, its reflectors are folded into the compact WY
+// form I - Y * T * Y^T, and Q^T is applied to the trailing columns and to
+// the optional right-hand side with matrix-matrix work only.
+static void FactorQR(std::vector<double> &a, int m, int n,
+                     std::vector<double> &tau, std::vector<double> *rhs,
+                     int rhs_cols, std::vector<std::vector<double>> *blocks) {
+  int k = std::min(m, n);
+  tau.assign(k, 0.0);
+  for (int first = 0; first < k; first += kQRBlock) {
+    int width = std::min(kQRBlock, k - first);
+    for (int j = first; j < first + width; ++j) {
+      double norm = 0.0;
+      for (int i = j + 1; i < m; ++i) {
+        norm += a[(size_t)i * n + j] * a[(size_t)i * n + j];
+      }
+      double head = a[(size_t)j * n + j];
+      if (norm == 0.0) continue;
+      double beta = sqrt(head * head + norm);
+      if (head > 0) beta = -beta;
+      tau[j] = (beta - head) / beta;
+      for (int i = j + 1; i < m; ++i) a[(size_t)i * n + j] /= head - beta;
+      a[(size_t)j * n + j] = beta;
+      for (int c = j + 1; c < first + width; ++c) {
+        double sum = a[(size_t)j * n + c];
+        for (int i = j + 1; i < m; ++i) {
+          sum += a[(size_t)i * n + j] * a[(size_t)i * n + c];
+        }
+        sum *= tau[j];
+        a[(size_t)j * n + c] -= sum;
+        for (int i = j + 1; i < m; ++i) {
+          a[(size_t)i * n + c] -= sum * a[(size_t)i * n + j];
+        }
+      }
+    }
+
+    std::vector<double> t((size_t)width * width, 0.0);
+    for (int p = 0; p < width; ++p) {
+      int col = first + p;
+      t[p * width + p] = tau[col];
+      std::vector<double> dots(p, 0.0);
+      for (int q = 0; q < p; ++q) {
+        double sum = a[(size_t)col * n + first + q];
+        for (int i = col + 1; i < m; ++i) {
+          sum += a[(size_t)i * n + first + q] * a[(size_t)i * n + col];
+        }
+        dots[q] = sum;
+      }
+      for (int q = 0; q < p; ++q) {
+        double sum = 0.0;
+        for (int s = q; s < p; ++s) sum += t[q * width + s] * dots[s];
+        t[q * width + p] = -tau[col] * sum;
+      }
+    }
+
+    if (first + width < n) {
+      ApplyBlockReflector(a, m, n, first, width, t, a.data() + first + width,
+                          n, n - first - width, true);
+    }
+    if (rhs != nullptr) {
+      ApplyBlockReflector(a, m, n, first, width, t, rhs->data(), rhs_cols,
+                          rhs_cols, true);
+    }
+    if (blocks != nullptr) blocks->push_back(std::move(t));
+  }
+}
+
+S21QR S21QRDecomposition(const S21Matrix &matrix) {
+  int m = matrix.GetRows(), n = matrix.GetCols(), k = std::min(m, n);
+  std::vector<double> a((size_t)m * n), tau;
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) a[(size_t)i * n + j] = matrix(i, j);
+  }
+  std::vector<std::vector<double>> blocks;
+  FactorQR(a, m, n, tau, nullptr, 0, &blocks);
+
+  std::vector<double> q((size_t)m * k, 0.0);
+  for (int i = 0; i < k; ++i) q[(size_t)i * k + i] = 1.0;
+  for (int block = (int)blocks.size() - 1; block >= 0; --block) {
+    int first = block * kQRBlock, width = std::min(kQRBlock, k - first);
+    ApplyBlockReflector(a, m, n, first, width, blocks[block], q.data(), k, k,
+                        false);
+  }
+
+  S21QR result{S21Matrix(m, k), S21Matrix(k, n)};
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < k; ++j) result.q(i, j) = q[(size_t)i * k + j];
+  }
+  for (int i = 0; i < k; ++i) {
+    for (int j = i; j < n; ++j) result.r(i, j) = a[(size_t)i * n + j];
+  }
+  return result;
+}
+
+// Back substitution R * x = c for the leading n x n triangle of `r`, which
+// has `stride` doubles per row.
+static S21Matrix SolveTriangular(const std::vector<double> &r, int n,
+                                 int stride, const std::vector<double> &c,
+                                 int c_cols) {
+  double max_diagonal = 0.0;
+  for (int i = 0; i < n; ++i) {
+    max_diagonal = std::max(max_diagonal, fabs(r[(size_t)i * stride + i]));
+  }
+  S21Matrix result(n, c_cols);
+  for (int i = n - 1; i >= 0; --i) {
+    double diagonal = r[(size_t)i * stride + i];
+    if (fabs(diagonal) <= n * DBL_EPSILON * max_diagonal) {
+      throw std::invalid_argument("The matrix is rank deficient");
+    }
+    for (int j = 0; j < c_cols; ++j) {
+      double sum = c[(size_t)i * c_cols + j];
+      for (int s = i + 1; s < n; ++s) {
+        sum -= r[(size_t)i * stride + s] * result(s, j);
+      }
+      result(i, j) = sum / diagonal;
+    }
+  }
+  return result;
+}
+
+S21Matrix S21LeastSquares(const S21Matrix &a, const S21Matrix &b) {
+  int m = a.GetRows(), n = a.GetCols(), k = b.GetCols();
+  if (m < n) {
+    throw std::invalid_argument(
+        "Least squares needs at least as many rows as columns");
+  }
+  if (b.GetRows() != m) {
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as the "
+        "matrix");
+  }
+  std::vector<double> work((size_t)m * n), rhs((size_t)m * k), tau;
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) work[(size_t)i * n + j] = a(i, j);
+    for (int j = 0; j < k; ++j) rhs[(size_t)i * k + j] = b(i, j);
+  }
+  FactorQR(work, m, n, tau, &rhs, k, nullptr);
+  return SolveTriangular(work, n, n, rhs, k);
+}
+
+S21StreamingQR::S21StreamingQR(int cols, int rhs_cols)
+    : cols_(cols), rhs_cols_(rhs_cols), rows_seen_(0) {
+  if (cols < 1 || rhs_cols < 1) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have cols and rows");
+  }
+  r_.assign((size_t)cols_ * cols_, 0.0);
+  qtb_.assign((size_t)cols_ * rhs_cols_, 0.0);
+}
+
+// Replaces (r, qtb) by the triangular factor and projected right-hand side
+// of the 2n rows [r; other_r] with [qtb; other_qtb].
+static void MergeFactors(std::vector<double> &r, std::vector<double> &qtb,
+                         const std::vector<double> &other_r,
+                         const std::vector<double> &other_qtb, int n, int k) {
+  std::vector<double> a(r), b(qtb), tau;
+  a.insert(a.end(), other_r.begin(), other_r.end());
+  b.insert(b.end(), other_qtb.begin(), other_qtb.end());
+  FactorQR(a, 2 * n, n, tau, &b, k, nullptr);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      r[(size_t)i * n + j] = j >= i ? a[(size_t)i * n + j] : 0.0;
+    }
+  }
+  std::copy(b.begin(), b.begin() + (size_t)n * k, qtb.begin());
+}
+
+// The block is cut into chunks of at least 2n rows and every pool thread
+// takes a contiguous run of them, folding each chunk into its own n x n
+// factor right away. The per-thread factors and the current one are then
+// merged pairwise in a tree, one pool task per pair, so no step holds more
+// than a chunk and two factors.
+void S21StreamingQR::AddRows(const S21Matrix &rows, const S21Matrix &rhs) {
+  if (rows.GetCols() != cols_ || rhs.GetCols() != rhs_cols_ ||
+      rows.GetRows() != rhs.GetRows()) {
+    throw std::out_of_range(
+        "Incorrect input, block does not match the problem size");
+  }
+  int n = cols_, k = rhs_cols_, count = rows.GetRows();
+  int chunk = std::max(2 * n, 256);
+  int chunks = (count + chunk - 1) / chunk;
+  int parts = std::min(chunks, S21ThreadPool::Default().GetThreads());
+  // Slot 0 keeps the current factor, slot p + 1 the factor of part p.
+  std::vector<std::vector<double>> factors(parts + 1), projected(parts + 1);
+  factors[0] = r_;
+  projected[0] = qtb_;
+  S21ThreadPool::Default().ParallelFor(0, parts, 1, [&](int begin, int end) {
+    for (int part = begin; part < end; ++part) {
+      std::vector<double> &r = factors[part + 1], &qtb = projected[part + 1];
+      for (int c = (long long)part * chunks / parts;
+           c < (long long)(part + 1) * chunks / parts; ++c) {
+        int first = c * chunk, height = std::min(chunk, count - first);
+        std::vector<double> a((size_t)height * n), b((size_t)height * k),
+            tau;
+        for (int i = 0; i < height; ++i) {
+          for (int j = 0; j < n; ++j) {
+            a[(size_t)i * n + j] = rows(first + i, j);
+          }
+          for (int j = 0; j < k; ++j) b[(size_t)i * k + j] = rhs(first + i, j);
+        }
+        FactorQR(a, height, n, tau, &b, k, nullptr);
+        std::vector<double> chunk_r((size_t)n * n, 0.0),
+            chunk_qtb((size_t)n * k, 0.0);
+        for (int i = 0; i < std::min(height, n); ++i) {
+          for (int j = i; j < n; ++j) {
+            chunk_r[(size_t)i * n + j] = a[(size_t)i * n + j];
+          }
+          for (int j = 0; j < k; ++j) {
+            chunk_qtb[(size_t)i * k + j] = b[(size_t)i * k + j];
+          }
+        }
+        if (r.empty()) {
+          r = std::move(chunk_r);
+          qtb = std::move(chunk_qtb);
+        } else {
+          MergeFactors(r, qtb, chunk_r, chunk_qtb, n, k);
+        }
+      }
+    }
+  });
+
+  for (int left = parts + 1; left > 1; left = (left + 1) / 2) {
+    S21ThreadPool::Default().ParallelFor(
+        0, left / 2, 1, [&](int begin, int end) {
+          for (int pair = begin; pair < end; ++pair) {
+            MergeFactors(factors[2 * pair], projected[2 * pair],
+                         factors[2 * pair + 1], projected[2 * pair + 1], n,
+                         k);
+            factors[2 * pair + 1] = {};
+            projected[2 * pair + 1] = {};
+          }
+        });
+    for (int slot = 1; slot < (left + 1) / 2; ++slot) {
+      factors[slot] = std::move(factors[2 * slot]);
+      projected[slot] = std::move(projected[2 * slot]);
+    }
+  }
+  r_ = std::move(factors[0]);
+  qtb_ = std::move(projected[0]);
+  rows_seen_ += count;
+}
+
+S21Matrix S21StreamingQR::GetR() const {
+  S21Matrix result(cols_, cols_);
+  for (int i = 0; i < cols_; ++i) {
+    for (int j = i; j < cols_; ++j) result(i, j) = r_[(size_t)i * cols_ + j];
+  }
+  return result;
+}
+
+S21Matrix S21StreamingQR::Solve() const {
+  if (rows_seen_ < cols_) {
+    throw std::invalid_argument(
+        "Least squares needs at least as many rows as columns");
+  }
+  return SolveTriangular(r_, cols_, cols_, qtb_, rhs_cols_);
+}
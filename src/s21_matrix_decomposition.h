@@ -0,0 +1,57 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_DECOMPOSITION_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_DECOMPOSITION_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// A = vectors * diag(values) * vectors^T, values in ascending order and the
+// matching orthonormal eigenvectors in the columns of `vectors`.
+struct S21SymmetricEigen {
+  std::vector<double> values;
+  S21Matrix vectors;
+};
+
+// Thin decomposition A = u * diag(singular) * v^T of an m x n matrix with
+// k = min(m, n): u is m x k, v is n x k and singular values are descending.
+// Columns of u that belong to zero singular values are left zero.
+struct S21SingularValues {
+  S21Matrix u;
+  std::vector<double> singular;
+  S21Matrix v;
+};
+
+// Thin decomposition A = q * r of an m x n matrix with k = min(m, n): q is
+// m x k with orthonormal columns and r is k x n upper triangular.
+struct S21QR {
+  S21Matrix q;
+  S21Matrix r;
+};
+
+S21SymmetricEigen S21EigenSymmetric(const S21Matrix& matrix);
+S21SingularValues S21SingularValueDecomposition(const S21Matrix& matrix);
+S21QR S21QRDecomposition(const S21Matrix& matrix);
+// Minimizes ||a * x - b|| for a with at least as many rows as columns and
+// full column rank, through QR without forming a^T * a.
+S21Matrix S21LeastSquares(const S21Matrix& a, const S21Matrix& b);
+
+// Least squares over rows that arrive in blocks (TSQR). Only the n x n
+// triangular factor and the matching n rows of Q^T * b are kept between
+// blocks, so the tall matrix never has to be in memory at once. A large
+// block is split into row chunks that are factored on the pool in parallel
+// and merged pairwise in a tree.
+class S21StreamingQR {
+ public:
+  S21StreamingQR(int cols, int rhs_cols);
+
+  void AddRows(const S21Matrix& rows, const S21Matrix& rhs);
+  S21Matrix GetR() const;
+  S21Matrix Solve() const;
+
+ private:
+  int cols_, rhs_cols_;
+  long long rows_seen_;
+  std::vector<double> r_, qtb_;
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_DECOMPOSITION_H_
@@ -1,17 +1,168 @@
 #include "s21_matrix_oop.h"
 
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_matrix_decomposition.h"
+#include "s21_numa.h"
+#include "s21_thread_pool.h"
+#include "s21_vector.h"
+
+// Up to this size the cofactor expansion is cheaper than a factorization and
+// gives exact results for small integer matrices.
+const int kMinorComplementsLimit = 3;
+
+// Elements a single pool task should at least touch in the bandwidth-bound
+// kernels; smaller problems stay on the calling thread.
+const int kParallelWork = 1 << 15;
+
+// Data blocks from this many elements (2 MiB) on get their own mapping,
+// aligned to a huge page, marked for transparent huge pages and placed by
+// the NUMA policy.
+const size_t kLargeElements = 1 << 18;
+const size_t kHugePageBytes = 1 << 21;
+
+static size_t LargeBytes(size_t count) {
+  return (count * sizeof(double) + kHugePageBytes - 1) / kHugePageBytes *
+         kHugePageBytes;
+}
+
+// A fresh anonymous mapping has no pages yet, unlike heap memory that may
+// come back already faulted in, so the huge page hint and the first touch
+// decide how it is backed. Mapping one huge page more and trimming both
+// ends gives the alignment. The pages read as zero until written.
+static double *MapLarge(size_t bytes) {
+  size_t span = bytes + kHugePageBytes;
+  void *map = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) throw std::bad_alloc();
+  uintptr_t start = (uintptr_t)map;
+  uintptr_t data = (start + kHugePageBytes - 1) / kHugePageBytes *
+                   kHugePageBytes;
+  if (data > start) munmap(map, data - start);
+  if (start + span > data + bytes) {
+    munmap((void *)(data + bytes), start + span - (data + bytes));
+  }
+#ifdef __linux__
+  // Only a hint, kernels without transparent huge pages ignore it.
+  madvise((void *)data, bytes, MADV_HUGEPAGE);
+#endif
+  return (double *)data;
+}
+
+// Runs body(first, last) over row blocks of a rows x cols matrix. Under the
+// local NUMA policy the blocks are the per-worker ones used for first touch
+// in Create, so streaming kernels stay on the node that holds their rows.
+static void ForEachRowBlock(int rows, int cols,
+                            const std::function<void(int, int)> &body) {
+  if ((long long)rows * cols < kParallelWork) {
+    body(0, rows);
+  } else if (S21GetNumaPolicy() == S21NumaPolicy::kLocal) {
+    S21ThreadPool::Default().ParallelForByThread(0, rows, body);
+  } else {
+    S21ThreadPool::Default().ParallelFor(
+        0, rows, std::max(1, kParallelWork / cols), body);
+  }
+}
+
+// Rows per reduction block: at least kParallelWork elements and at most
+// four blocks per pool thread.
+static int ReductionBlockSize(int rows, int cols) {
+  int most = 4 * S21ThreadPool::Default().GetThreads();
+  return std::max({1, kParallelWork / cols, (rows + most - 1) / most});
+}
+
+// How many blocks ForEachReductionBlock splits the rows into, so callers
+// can size their partials before running it.
+static int ReductionBlocks(int rows, int cols) {
+  int size = ReductionBlockSize(rows, cols);
+  return (rows + size - 1) / size;
+}
 
-void S21Matrix::Create(int rows, int cols) {
+// Runs body(block, first, last) for each of the ReductionBlocks(rows, cols)
+// row blocks on the pool and returns their count. Callers keep one partial
+// per block and merge them in block order, so reductions do not depend on
+// how the pool scheduled the blocks.
+static int ForEachReductionBlock(
+    int rows, int cols, const std::function<void(int, int, int)> &body) {
+  int size = ReductionBlockSize(rows, cols);
+  int blocks = ReductionBlocks(rows, cols);
+  S21ThreadPool::Default().ParallelFor(
+      0, blocks, 1, [&body, rows, size](int first, int last) {
+        for (int block = first; block < last; ++block) {
+          body(block, block * size, std::min(rows, (block + 1) * size));
+        }
+      });
+  return blocks;
+}
+
+// The row table and, unless `zero` is set, small data blocks are left
+// unset. Large blocks are always zero. Under the local NUMA policy their
+// rows are written once anyway, because that first touch is what places
+// the pages; the interleave policy is set before any page exists.
+void S21Matrix::Create(int rows, int cols, bool zero) {
   rows_ = rows;
   cols_ = cols;
-  matrix_ = new double *[rows_]();
-  matrix_[0] = new double[rows_ * cols_]();
+  matrix_ = new double *[rows_];
+  size_t count = (size_t)rows_ * cols_;
+  if (count < kLargeElements) {
+    matrix_[0] = zero ? new double[count]() : new double[count];
+  } else {
+    size_t bytes = LargeBytes(count);
+    double *data;
+    try {
+      data = MapLarge(bytes);
+    } catch (...) {
+      delete[] matrix_;
+      throw;
+    }
+    S21NumaPolicy policy = S21GetNumaPolicy();
+    if (policy == S21NumaPolicy::kInterleave) {
+      S21NumaInterleave(data, bytes);
+    } else if (policy == S21NumaPolicy::kLocal) {
+      size_t width = (size_t)cols_;
+      ForEachRowBlock(rows_, cols_, [data, width](int first, int last) {
+        S21Scale(0.0, data + first * width, (last - first) * width);
+      });
+    }
+    matrix_[0] = data;
+  }
   for (size_t i = 1; i < (size_t)rows_; ++i) {
     matrix_[i] = matrix_[i - 1] + cols_;
   }
+  refs_ = new std::atomic<int>(1);
+}
+
+// Drops this owner; the last one frees the buffer.
+void S21Matrix::Destroy() {
+  if (refs_->fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  if ((size_t)rows_ * cols_ < kLargeElements) {
+    delete[] matrix_[0];
+  } else {
+    munmap(matrix_[0], LargeBytes((size_t)rows_ * cols_));
+  }
+  delete[] matrix_;
+  delete refs_;
+}
+
+// Gives this matrix a private buffer before a write. A sole owner keeps its
+// buffer: nobody else can start sharing it while this object is written.
+void S21Matrix::Detach() {
+  if (refs_ == nullptr || refs_->load(std::memory_order_acquire) == 1) {
+    return;
+  }
+  S21Matrix copy(rows_, cols_, S21Uninitialized());
+  std::copy(matrix_[0], matrix_[0] + (size_t)rows_ * cols_, copy.matrix_[0]);
+  *this = std::move(copy);
 }
 
 S21Matrix::S21Matrix() { Create(1, 1); }
@@ -24,69 +175,74 @@ S21Matrix::S21Matrix(int rows, int cols) {
   Create(rows, cols);
 }
 
-S21Matrix::S21Matrix(const S21Matrix &other) {
-  rows_ = other.rows_;
-  cols_ = other.cols_;
-
-  Create(rows_, cols_);
-
-  for (size_t i = 0; i < (size_t)rows_; ++i) {
-    for (size_t j = 0; j < (size_t)cols_; ++j) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
+S21Matrix::S21Matrix(int rows, int cols, S21Uninitialized) {
+  if (rows < 1 || cols < 1) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have cols and rows");
   }
+  Create(rows, cols, false);
+}
+
+S21Matrix::S21Matrix(const S21Matrix &other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      matrix_(other.matrix_),
+      refs_(other.refs_) {
+  if (refs_ != nullptr) refs_->fetch_add(1, std::memory_order_relaxed);
 }
 
 S21Matrix::S21Matrix(S21Matrix &&other) noexcept {
   matrix_ = other.matrix_;
+  refs_ = other.refs_;
   rows_ = other.rows_;
   cols_ = other.cols_;
 
   other.matrix_ = nullptr;
+  other.refs_ = nullptr;
   other.cols_ = 0;
   other.rows_ = 0;
 }
 
 S21Matrix::~S21Matrix() {
   if (matrix_ != nullptr) {
-    delete[] matrix_[0];
-    delete[] matrix_;
+    Destroy();
     matrix_ = nullptr;
+    refs_ = nullptr;
     rows_ = 0;
     cols_ = 0;
   }
 }
 
 S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
-  if (&other != this) {
-    if (rows_ != other.rows_ || cols_ != other.cols_) {
-      delete[] matrix_[0];
-      delete[] matrix_;
-      Create(other.rows_, other.cols_);
+  if (&other != this && other.matrix_ != matrix_) {
+    if (other.refs_ != nullptr) {
+      other.refs_->fetch_add(1, std::memory_order_relaxed);
+    }
+    if (matrix_ != nullptr) {
+      Destroy();
     }
 
     rows_ = other.rows_;
     cols_ = other.cols_;
-
-    for (size_t i = 0; i < (size_t)rows_; ++i) {
-      for (size_t j = 0; j < (size_t)cols_; ++j) {
-        matrix_[i][j] = other.matrix_[i][j];
-      }
-    }
+    matrix_ = other.matrix_;
+    refs_ = other.refs_;
   }
   return *this;
 }
 
 S21Matrix &S21Matrix::operator=(S21Matrix &&other) noexcept {
   if (&other != this) {
-    delete[] matrix_[0];
-    delete[] matrix_;
+    if (matrix_ != nullptr) {
+      Destroy();
+    }
 
     rows_ = other.rows_;
     cols_ = other.cols_;
     matrix_ = other.matrix_;
+    refs_ = other.refs_;
 
     other.matrix_ = nullptr;
+    other.refs_ = nullptr;
     other.rows_ = 0;
     other.cols_ = 0;
   }
@@ -97,24 +253,27 @@ double &S21Matrix::operator()(int row, int col) {
   if (row >= rows_ || col >= cols_ || col < 0 || row < 0) {
     throw std::out_of_range("Incorrect input, index is out of range ");
   }
+  Detach();
   return matrix_[row][col];
 }
 
-double &S21Matrix::operator()(int row, int col) const {
+const double &S21Matrix::operator()(int row, int col) const {
   if (row >= rows_ || col >= cols_ || col < 0 || row < 0) {
     throw std::out_of_range("Incorrect input, index is out of range ");
   }
   return matrix_[row][col];
 }
 
-bool S21Matrix::operator==(const S21Matrix &other) { return EqMatrix(other); }
+bool S21Matrix::operator==(const S21Matrix &other) const {
+  return EqMatrix(other);
+}
 
 S21Matrix &S21Matrix::operator+=(const S21Matrix &other) {
   SumMatrix(other);
   return *this;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix &other) {
+S21Matrix S21Matrix::operator+(const S21Matrix &other) const {
   S21Matrix result(*this);
   result.SumMatrix(other);
   return result;
@@ -124,13 +283,13 @@ S21Matrix &S21Matrix::operator-=(const S21Matrix &other) {
   SubMatrix(other);
   return *this;
 }
-S21Matrix S21Matrix::operator-(const S21Matrix &other) {
+S21Matrix S21Matrix::operator-(const S21Matrix &other) const {
   S21Matrix result(*this);
   result.SubMatrix(other);
   return result;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix &other) {
+S21Matrix S21Matrix::operator*(const S21Matrix &other) const {
   S21Matrix result(*this);
   result.MulMatrix(other);
   return result;
@@ -147,7 +306,7 @@ S21Matrix &S21Matrix::operator*=(const S21Matrix &other) {
   return *this;
 }
 
-S21Matrix S21Matrix::operator*(const double num) {
+S21Matrix S21Matrix::operator*(const double num) const {
   S21Matrix result(*this);
   result.MulNumber(num);
   return result;
@@ -157,7 +316,8 @@ S21Matrix &S21Matrix::operator*=(const double num) {
   return *this;
 }
 
-bool S21Matrix::EqMatrix(const S21Matrix &other) {
+bool S21Matrix::EqMatrix(const S21Matrix &other) const {
+  if (matrix_ == other.matrix_) return true;
   bool result = true;
   if (rows_ == other.rows_ && cols_ == other.cols_) {
     for (size_t i = 0; i < (size_t)rows_; ++i) {
@@ -178,11 +338,12 @@ void S21Matrix::SumMatrix(const S21Matrix &other) {
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
   }
-  for (size_t i = 0; i < (size_t)rows_; ++i) {
-    for (size_t j = 0; j < (size_t)cols_; ++j) {
-      matrix_[i][j] += other.matrix_[i][j];
-    }
-  }
+  Detach();
+  ForEachRowBlock(rows_, cols_, [this, &other](int first, int last) {
+    size_t offset = (size_t)first * cols_;
+    S21Axpy(1.0, other.matrix_[0] + offset, matrix_[0] + offset,
+            (size_t)(last - first) * cols_);
+  });
 }
 
 void S21Matrix::SubMatrix(const S21Matrix &other) {
@@ -190,19 +351,21 @@ void S21Matrix::SubMatrix(const S21Matrix &other) {
     throw std::out_of_range(
         "Incorrect input, matrices should have the same size");
   }
-  for (size_t i = 0; i < (size_t)rows_; ++i) {
-    for (size_t j = 0; j < (size_t)cols_; ++j) {
-      matrix_[i][j] -= other.matrix_[i][j];
-    }
-  }
+  Detach();
+  ForEachRowBlock(rows_, cols_, [this, &other](int first, int last) {
+    size_t offset = (size_t)first * cols_;
+    S21Axpy(-1.0, other.matrix_[0] + offset, matrix_[0] + offset,
+            (size_t)(last - first) * cols_);
+  });
 }
 
 void S21Matrix::MulNumber(const double num) {
-  for (size_t i = 0; i < (size_t)rows_; ++i) {
-    for (size_t j = 0; j < (size_t)cols_; ++j) {
-      matrix_[i][j] *= num;
+  Detach();
+  ForEachRowBlock(rows_, cols_, [this, num](int first, int last) {
+    for (size_t i = (size_t)first * cols_; i < (size_t)last * cols_; ++i) {
+      matrix_[0][i] *= num;
     }
-  }
+  });
 }
 void S21Matrix::MulMatrix(const S21Matrix &other) {
   if (cols_ != other.rows_) {
@@ -211,19 +374,33 @@ void S21Matrix::MulMatrix(const S21Matrix &other) {
         "number "
         "of rows of the second matrix");
   }
-  S21Matrix result(rows_, other.cols_);
-  for (size_t i = 0; i < (size_t)rows_; ++i) {
-    for (size_t j = 0; j < (size_t)other.cols_; ++j) {
-      for (size_t s = 0; s < (size_t)other.rows_; ++s) {
-        result.matrix_[i][j] += matrix_[i][s] * other.matrix_[s][j];
-      }
-    }
-  }
-  *this = result;
+  S21Matrix result(rows_, other.cols_, S21Uninitialized());
+  Multiply(*this, other, result);
+  *this = std::move(result);
 }
 
-S21Matrix S21Matrix::Transpose() {
-  S21Matrix result(cols_, rows_);
+// result = left * right into a buffer of the right size that aliases
+// neither operand. Each output row combines the rows of `right` under the
+// current S21Accumulation mode, so both operands are read along rows; rows
+// go to the pool.
+void S21Matrix::Multiply(const S21Matrix &left, const S21Matrix &right,
+                         S21Matrix &result) {
+  size_t inner = (size_t)left.cols_, cols = (size_t)right.cols_;
+  S21ThreadPool::Default().ParallelFor(
+      0, left.rows_,
+      std::max(1, (int)(kParallelWork / ((long long)inner * cols))),
+      [&](int first, int last) {
+        for (size_t i = (size_t)first; i < (size_t)last; ++i) {
+          double *out = result.matrix_[i];
+          S21Scale(0.0, out, cols);
+          S21CombineRows(1.0, left.matrix_[i], right.matrix_, inner, 0, out,
+                         cols);
+        }
+      });
+}
+
+S21Matrix S21Matrix::Transpose() const {
+  S21Matrix result(cols_, rows_, S21Uninitialized());
   for (size_t i = 0; i < (size_t)cols_; ++i) {
     for (size_t j = 0; j < (size_t)rows_; ++j) {
       result.matrix_[i][j] = matrix_[j][i];
@@ -232,11 +409,18 @@ S21Matrix S21Matrix::Transpose() {
   return result;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
-  S21Matrix result(rows_, cols_);
+S21Matrix S21Matrix::CalcComplements() const {
   if (rows_ != cols_) {
     throw std::invalid_argument("The matrix is not square");
   }
+  if (rows_ <= kMinorComplementsLimit) {
+    return ComplementsByMinors();
+  }
+  return ComplementsByLU();
+}
+
+S21Matrix S21Matrix::ComplementsByMinors() const {
+  S21Matrix result(rows_, cols_);
   for (size_t i = 0; i < (size_t)rows_; ++i) {
     for (size_t j = 0; j != (size_t)cols_; ++j) {
       S21Matrix minor_matrix = Minor(i, j);
@@ -246,12 +430,157 @@ S21Matrix S21Matrix::CalcComplements() {
   return result;
 }
 
-double S21Matrix::Determinant() {
+// Complements are the transposed adjugate. With P * A * Q = L * U the
+// adjugate is sign * Q * adj(U) * L^-1 * P, and for U = [[U1, w], [0, t]]
+// adj(U) = det(U1) * [[t * U1^-1, -U1^-1 * w], [0, 1]] holds for any t, so the
+// same O(n^3) path covers singular matrices of rank n - 1. Full pivoting keeps
+// U1 non-singular whenever the rank allows it; lower ranks give a zero result.
+S21Matrix S21Matrix::ComplementsByLU() const {
+  size_t n = (size_t)rows_, m = n - 1;
+  std::vector<int> row_perm, col_perm;
+  int sign = 1, rank = 0;
+  S21Matrix lu = DecomposeLU(row_perm, col_perm, sign, rank);
+  S21Matrix result(rows_, cols_);
+  if ((size_t)rank < m) {
+    return result;
+  }
+  double t = (size_t)rank == n ? lu.matrix_[m][m] : 0.0;
+
+  S21Matrix u1_inv(m, m);
+  double det_u1 = 1.0;
+  for (size_t j = 0; j < m; ++j) {
+    det_u1 *= lu.matrix_[j][j];
+    u1_inv.matrix_[j][j] = 1.0 / lu.matrix_[j][j];
+    for (size_t i = j; i-- > 0;) {
+      double sum = 0.0;
+      for (size_t k = i + 1; k <= j; ++k) {
+        sum += lu.matrix_[i][k] * u1_inv.matrix_[k][j];
+      }
+      u1_inv.matrix_[i][j] = -sum / lu.matrix_[i][i];
+    }
+  }
+
+  S21Matrix adj_u(rows_, cols_);
+  for (size_t i = 0; i < m; ++i) {
+    double sum = 0.0;
+    for (size_t k = i; k < m; ++k) {
+      adj_u.matrix_[i][k] = det_u1 * t * u1_inv.matrix_[i][k];
+      sum += u1_inv.matrix_[i][k] * lu.matrix_[k][m];
+    }
+    adj_u.matrix_[i][m] = -det_u1 * sum;
+  }
+  adj_u.matrix_[m][m] = det_u1;
+
+  S21Matrix l_inv(rows_, cols_);
+  for (size_t j = 0; j < n; ++j) {
+    l_inv.matrix_[j][j] = 1.0;
+    for (size_t i = j + 1; i < n; ++i) {
+      double sum = 0.0;
+      for (size_t k = j; k < i; ++k) {
+        sum += lu.matrix_[i][k] * l_inv.matrix_[k][j];
+      }
+      l_inv.matrix_[i][j] = -sum;
+    }
+  }
+
+  for (size_t k = 0; k < n; ++k) {
+    for (size_t l = 0; l < n; ++l) {
+      double sum = 0.0;
+      for (size_t p = k > l ? k : l; p < n; ++p) {
+        sum += adj_u.matrix_[k][p] * l_inv.matrix_[p][l];
+      }
+      result.matrix_[row_perm[l]][col_perm[k]] = sign * sum;
+    }
+  }
+  return result;
+}
+
+S21Matrix S21Matrix::DecomposeLU(std::vector<int> &row_perm,
+                                 std::vector<int> &col_perm, int &sign,
+                                 int &rank,
+                                 const std::atomic<bool> *cancelled) const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  size_t n = (size_t)rows_;
+  S21Matrix lu(*this);
+  lu.Detach();
+  row_perm.resize(n);
+  col_perm.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    row_perm[i] = i;
+    col_perm[i] = i;
+  }
+  sign = 1;
+  rank = rows_;
+
+  double max_abs = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      max_abs = fmax(max_abs, fabs(lu.matrix_[i][j]));
+    }
+  }
+  double tolerance = n * DBL_EPSILON * max_abs;
+
+  for (size_t k = 0; k < n; ++k) {
+    if (cancelled != nullptr && *cancelled) {
+      throw std::runtime_error("Operation was cancelled");
+    }
+    size_t pivot_row = k, pivot_col = k;
+    double pivot_abs = -1.0;
+    for (size_t i = k; i < n; ++i) {
+      for (size_t j = k; j < n; ++j) {
+        if (fabs(lu.matrix_[i][j]) > pivot_abs) {
+          pivot_abs = fabs(lu.matrix_[i][j]);
+          pivot_row = i;
+          pivot_col = j;
+        }
+      }
+    }
+    if (pivot_abs <= tolerance) {
+      rank = k;
+      break;
+    }
+    if (pivot_row != k) {
+      for (size_t j = 0; j < n; ++j) {
+        std::swap(lu.matrix_[k][j], lu.matrix_[pivot_row][j]);
+      }
+      std::swap(row_perm[k], row_perm[pivot_row]);
+      sign = -sign;
+    }
+    if (pivot_col != k) {
+      for (size_t i = 0; i < n; ++i) {
+        std::swap(lu.matrix_[i][k], lu.matrix_[i][pivot_col]);
+      }
+      std::swap(col_perm[k], col_perm[pivot_col]);
+      sign = -sign;
+    }
+    for (size_t i = k + 1; i < n; ++i) {
+      double factor = lu.matrix_[i][k] /= lu.matrix_[k][k];
+      for (size_t j = k + 1; j < n; ++j) {
+        lu.matrix_[i][j] -= factor * lu.matrix_[k][j];
+      }
+    }
+  }
+  return lu;
+}
+
+double S21Matrix::Determinant() const {
   if (rows_ != cols_) {
     throw std::invalid_argument("The matrix is not square");
   }
   double result = 0.0;
-  if (rows_ == 1) {
+  if (rows_ > kMinorComplementsLimit) {
+    std::vector<int> row_perm, col_perm;
+    int sign = 1, rank = 0;
+    S21Matrix lu = DecomposeLU(row_perm, col_perm, sign, rank);
+    if (rank == rows_) {
+      result = sign;
+      for (size_t i = 0; i < (size_t)rows_; ++i) {
+        result *= lu.matrix_[i][i];
+      }
+    }
+  } else if (rows_ == 1) {
     result = matrix_[0][0];
   } else if (rows_ == 2) {
     result = matrix_[0][0] * matrix_[1][1] - matrix_[0][1] * matrix_[1][0];
@@ -264,8 +593,8 @@ double S21Matrix::Determinant() {
   return result;
 }
 
-S21Matrix S21Matrix::Minor(int row, int col) {
-  S21Matrix result(rows_ - 1, cols_ - 1);
+S21Matrix S21Matrix::Minor(int row, int col) const {
+  S21Matrix result(rows_ - 1, cols_ - 1, S21Uninitialized());
   for (size_t i = 0, min_i = 0; min_i < (size_t)result.rows_; ++min_i) {
     if ((size_t)row == i) ++i;
     for (size_t j = 0, min_j = 0; min_j < (size_t)result.cols_; ++min_j) {
@@ -278,7 +607,7 @@ S21Matrix S21Matrix::Minor(int row, int col) {
   return result;
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
+S21Matrix S21Matrix::InverseMatrix() const {
   double det = Determinant();
   if (fabs(det) < eps) {
     throw std::invalid_argument("Matrix determinant is 0");
@@ -294,6 +623,533 @@ S21Matrix S21Matrix::InverseMatrix() {
   return result;
 }
 
+S21Matrix S21Matrix::Solve(const S21Matrix &rhs) const {
+  if (rows_ != rhs.rows_) {
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as the "
+        "matrix");
+  }
+  std::vector<int> row_perm, col_perm;
+  int sign = 1, rank = 0;
+  S21Matrix lu = DecomposeLU(row_perm, col_perm, sign, rank);
+  if (rank != rows_) {
+    throw std::invalid_argument("Matrix determinant is 0");
+  }
+  size_t n = (size_t)rows_;
+  S21Matrix y(rows_, rhs.cols_, S21Uninitialized());
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < (size_t)rhs.cols_; ++j) {
+      y.matrix_[i][j] = rhs.matrix_[row_perm[i]][j];
+    }
+    for (size_t k = 0; k < i; ++k) {
+      double factor = lu.matrix_[i][k];
+      for (size_t j = 0; j < (size_t)rhs.cols_; ++j) {
+        y.matrix_[i][j] -= factor * y.matrix_[k][j];
+      }
+    }
+  }
+  for (size_t i = n; i-- > 0;) {
+    for (size_t k = i + 1; k < n; ++k) {
+      double factor = lu.matrix_[i][k];
+      for (size_t j = 0; j < (size_t)rhs.cols_; ++j) {
+        y.matrix_[i][j] -= factor * y.matrix_[k][j];
+      }
+    }
+    for (size_t j = 0; j < (size_t)rhs.cols_; ++j) {
+      y.matrix_[i][j] /= lu.matrix_[i][i];
+    }
+  }
+  S21Matrix result(rows_, rhs.cols_, S21Uninitialized());
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < (size_t)rhs.cols_; ++j) {
+      result.matrix_[col_perm[i]][j] = y.matrix_[i][j];
+    }
+  }
+  return result;
+}
+
+S21Vector S21Matrix::MulVector(const S21Vector &x) const {
+  S21Vector result(rows_);
+  MulVector(x, result);
+  return result;
+}
+
+// y = alpha * A * x + beta * y as one dot product per row, rows split over
+// the pool.
+void S21Matrix::MulVector(const S21Vector &x, S21Vector &y, double alpha,
+                          double beta) const {
+  if (x.GetSize() != cols_ || y.GetSize() != rows_) {
+    throw std::out_of_range(
+        "Incorrect input, vector sizes do not match the matrix");
+  }
+  if (&x == &y) {
+    throw std::invalid_argument("Input and output vectors should differ");
+  }
+  const double *in = x.Data();
+  double *out = y.Data();
+  ForEachRowBlock(rows_, cols_, [&](int first, int last) {
+    for (int i = first; i < last; ++i) {
+      double value = alpha * S21Dot(matrix_[i], in, cols_);
+      out[i] = beta == 0.0 ? value : value + beta * out[i];
+    }
+  });
+}
+
+S21Vector S21Matrix::MulVectorTransposed(const S21Vector &x) const {
+  S21Vector result(cols_);
+  MulVectorTransposed(x, result);
+  return result;
+}
+
+// y = alpha * A^T * x + beta * y as row-wise AXPYs, so rows are still read
+// contiguously. The pool splits the columns, each task owning a slice of y.
+void S21Matrix::MulVectorTransposed(const S21Vector &x, S21Vector &y,
+                                    double alpha, double beta) const {
+  if (x.GetSize() != rows_ || y.GetSize() != cols_) {
+    throw std::out_of_range(
+        "Incorrect input, vector sizes do not match the matrix");
+  }
+  if (&x == &y) {
+    throw std::invalid_argument("Input and output vectors should differ");
+  }
+  const double *in = x.Data();
+  double *out = y.Data();
+  S21ThreadPool::Default().ParallelFor(
+      0, cols_, std::max(256, kParallelWork / rows_), [&](int first, int last) {
+        S21Scale(beta, out + first, last - first);
+        S21CombineRows(alpha, in, matrix_, rows_, first, out + first,
+                       last - first);
+      });
+}
+
+// A += alpha * x * y^T (GER).
+void S21Matrix::RankOneUpdate(double alpha, const S21Vector &x,
+                              const S21Vector &y) {
+  if (x.GetSize() != rows_ || y.GetSize() != cols_) {
+    throw std::out_of_range(
+        "Incorrect input, vector sizes do not match the matrix");
+  }
+  const double *left = x.Data(), *right = y.Data();
+  Detach();
+  S21ThreadPool::Default().ParallelFor(
+      0, rows_, std::max(1, kParallelWork / cols_), [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+          S21Axpy(alpha * left[i], right, matrix_[i], cols_);
+        }
+      });
+}
+
+// C = alpha * A * A^T + beta * C (SYRK). Only the upper triangle is computed,
+// as dot products of contiguous rows of A, and then mirrored.
+void S21Matrix::RankKUpdate(double alpha, const S21Matrix &a, double beta) {
+  if (rows_ != cols_ || a.rows_ != rows_) {
+    throw std::out_of_range(
+        "Incorrect input, the matrix should be square with as many rows as "
+        "the factor");
+  }
+  if (&a == this) {
+    throw std::invalid_argument("Input and output matrices should differ");
+  }
+  Detach();
+  S21ThreadPool::Default().ParallelFor(
+      0, rows_,
+      std::max(1, (int)(kParallelWork / ((long long)rows_ * a.cols_))),
+      [&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+          for (int j = i; j < cols_; ++j) {
+            double value = alpha * S21Dot(a.matrix_[i], a.matrix_[j], a.cols_);
+            matrix_[i][j] =
+                beta == 0.0 ? value : value + beta * matrix_[i][j];
+            matrix_[j][i] = matrix_[i][j];
+          }
+        }
+      });
+}
+
+int S21Matrix::Rank() const {
+  S21SingularValues svd = S21SingularValueDecomposition(*this);
+  double tolerance =
+      std::max(rows_, cols_) * svd.singular[0] * DBL_EPSILON;
+  int rank = 0;
+  for (double value : svd.singular) {
+    if (value > tolerance) ++rank;
+  }
+  return rank;
+}
+
+// Ratio of the largest to the smallest singular value, infinite for
+// rank-deficient matrices.
+double S21Matrix::ConditionNumber() const {
+  S21SingularValues svd = S21SingularValueDecomposition(*this);
+  double smallest = svd.singular.back();
+  return smallest > 0.0 ? svd.singular[0] / smallest : INFINITY;
+}
+
+// Moore-Penrose inverse V * diag(1 / s) * U^T over the singular values above
+// the rank tolerance.
+S21Matrix S21Matrix::PseudoInverse() const {
+  S21SingularValues svd = S21SingularValueDecomposition(*this);
+  double tolerance =
+      std::max(rows_, cols_) * svd.singular[0] * DBL_EPSILON;
+  S21Matrix result(cols_, rows_);
+  for (size_t k = 0; k < svd.singular.size(); ++k) {
+    if (svd.singular[k] <= tolerance) break;
+    double inverse = 1.0 / svd.singular[k];
+    for (size_t i = 0; i < (size_t)cols_; ++i) {
+      double factor = svd.v.matrix_[i][k] * inverse;
+      for (size_t j = 0; j < (size_t)rows_; ++j) {
+        result.matrix_[i][j] += factor * svd.u.matrix_[j][k];
+      }
+    }
+  }
+  return result;
+}
+
+// Binary exponentiation: O(log |power|) products that ping-pong between
+// three preallocated buffers. Negative powers raise the inverse, power 0
+// gives the identity.
+S21Matrix S21Matrix::Pow(int power) const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  size_t size = (size_t)rows_ * cols_;
+  S21Matrix base(rows_, cols_, S21Uninitialized()), result(rows_, cols_),
+      scratch(rows_, cols_, S21Uninitialized());
+  if (power < 0) {
+    S21Matrix identity(rows_, cols_);
+    for (size_t i = 0; i < (size_t)rows_; ++i) identity.matrix_[i][i] = 1.0;
+    base = Solve(identity);
+  } else {
+    std::copy(matrix_[0], matrix_[0] + size, base.matrix_[0]);
+  }
+  // Kept as unsigned so that INT_MIN does not overflow on negation.
+  unsigned int left = power < 0 ? 0u - (unsigned int)power : power;
+  if (left == 0) {
+    for (size_t i = 0; i < (size_t)rows_; ++i) result.matrix_[i][i] = 1.0;
+    return result;
+  }
+  bool started = false;
+  for (;;) {
+    if (left & 1u) {
+      if (started) {
+        Multiply(result, base, scratch);
+        std::swap(result, scratch);
+      } else {
+        std::copy(base.matrix_[0], base.matrix_[0] + size, result.matrix_[0]);
+        started = true;
+      }
+    }
+    left >>= 1;
+    if (left == 0) break;
+    Multiply(base, base, scratch);
+    std::swap(base, scratch);
+  }
+  return result;
+}
+
+// Scaling and squaring with a diagonal Pade approximant (Higham, 2005): the
+// smallest degree whose error bound covers ||A||_1 is used, or A is scaled
+// by 2^-s into the degree 13 bound and the approximant squared s times.
+// r(A) = (V - U)^-1 (V + U) goes through Solve.
+S21Matrix S21Matrix::Exp() const {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  static const double kTheta[] = {1.495585217958292e-2, 2.539398330063230e-1,
+                                  9.504178996162932e-1, 2.097847961257068,
+                                  5.371920351148152};
+  static const int kDegree[] = {3, 5, 7, 9, 13};
+  static const double kCoefficients[][14] = {
+      {120.0, 60.0, 12.0, 1.0},
+      {30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0},
+      {17297280.0, 8648640.0, 1995840.0, 277200.0, 25200.0, 1512.0, 56.0,
+       1.0},
+      {17643225600.0, 8821612800.0, 2075673600.0, 302702400.0, 30270240.0,
+       2162160.0, 110880.0, 3960.0, 90.0, 1.0},
+      {64764752532480000.0, 32382376266240000.0, 7771770303897600.0,
+       1187353796428800.0, 129060195264000.0, 10559470521600.0,
+       670442572800.0, 33522128640.0, 1323241920.0, 40840800.0, 960960.0,
+       16380.0, 182.0, 1.0}};
+
+  size_t n = (size_t)rows_, size = n * n;
+  double norm = 0.0;
+  for (size_t j = 0; j < n; ++j) {
+    double column = 0.0;
+    for (size_t i = 0; i < n; ++i) column += fabs(matrix_[i][j]);
+    norm = std::max(norm, column);
+  }
+  int choice = 0, squarings = 0;
+  while (choice < 4 && norm > kTheta[choice]) ++choice;
+  S21Matrix a(*this);
+  if (norm > kTheta[4]) {
+    squarings = (int)std::ceil(std::log2(norm / kTheta[4]));
+    a.MulNumber(std::ldexp(1.0, -squarings));
+  }
+  const double *b = kCoefficients[choice];
+
+  // Even powers A^2, A^4, ... up to what the chosen degree needs.
+  int degree = kDegree[choice];
+  int count = degree == 13 ? 3 : (degree - 1) / 2;
+  std::vector<S21Matrix> even;
+  even.emplace_back(rows_, cols_, S21Uninitialized());
+  Multiply(a, a, even[0]);
+  for (int k = 1; k < count; ++k) {
+    even.emplace_back(rows_, cols_, S21Uninitialized());
+    Multiply(even[k - 1], even[0], even[k]);
+  }
+
+  S21Matrix u_inner(rows_, cols_), v(rows_, cols_), scratch(rows_, cols_);
+  if (degree == 13) {
+    // U = A [A6 (b13 A6 + b11 A4 + b9 A2) + b7 A6 + b5 A4 + b3 A2 + b1 I],
+    // V = A6 (b12 A6 + b10 A4 + b8 A2) + b6 A6 + b4 A4 + b2 A2 + b0 I.
+    for (int k = 0; k < 3; ++k) {
+      S21Axpy(b[2 * k + 9], even[k].matrix_[0], scratch.matrix_[0], size);
+    }
+    Multiply(even[2], scratch, u_inner);
+    S21Scale(0.0, scratch.matrix_[0], size);
+    for (int k = 0; k < 3; ++k) {
+      S21Axpy(b[2 * k + 8], even[k].matrix_[0], scratch.matrix_[0], size);
+    }
+    Multiply(even[2], scratch, v);
+    for (int k = 0; k < 3; ++k) {
+      S21Axpy(b[2 * k + 3], even[k].matrix_[0], u_inner.matrix_[0], size);
+      S21Axpy(b[2 * k + 2], even[k].matrix_[0], v.matrix_[0], size);
+    }
+  } else {
+    for (int k = 0; k < count; ++k) {
+      S21Axpy(b[2 * k + 3], even[k].matrix_[0], u_inner.matrix_[0], size);
+      S21Axpy(b[2 * k + 2], even[k].matrix_[0], v.matrix_[0], size);
+    }
+  }
+  for (size_t i = 0; i < n; ++i) {
+    u_inner.matrix_[i][i] += b[1];
+    v.matrix_[i][i] += b[0];
+  }
+  S21Matrix u(rows_, cols_, S21Uninitialized());
+  Multiply(a, u_inner, u);
+
+  S21Matrix numerator(v), denominator(std::move(v));
+  numerator.SumMatrix(u);
+  denominator.SubMatrix(u);
+  S21Matrix result = denominator.Solve(numerator);
+  for (int k = 0; k < squarings; ++k) {
+    Multiply(result, result, scratch);
+    std::swap(result, scratch);
+  }
+  return result;
+}
+
+double S21Matrix::Sum() const {
+  std::vector<double> partial(ReductionBlocks(rows_, cols_));
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [this, &partial](int block, int first, int last) {
+        partial[block] = S21Sum(matrix_[first], (size_t)(last - first) * cols_);
+      });
+  return S21Sum(partial.data(), blocks);
+}
+
+S21Vector S21Matrix::RowSums() const {
+  S21Vector result(rows_);
+  double *out = result.Data();
+  ForEachRowBlock(rows_, cols_, [this, out](int first, int last) {
+    for (int i = first; i < last; ++i) out[i] = S21Sum(matrix_[i], cols_);
+  });
+  return result;
+}
+
+// Column sums add whole rows into per-block partial rows, so the matrix is
+// only ever read along rows.
+S21Vector S21Matrix::ColSums() const {
+  S21Vector result(cols_);
+  std::vector<double> partial(ReductionBlocks(rows_, cols_) * (size_t)cols_);
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [this, &partial](int block, int first, int last) {
+        std::vector<double> ones(last - first, 1.0);
+        S21CombineRows(1.0, ones.data(), matrix_ + first, last - first, 0,
+                       partial.data() + (size_t)block * cols_, cols_);
+      });
+  std::vector<double> ones(blocks, 1.0);
+  std::vector<const double *> rows(blocks);
+  for (int block = 0; block < blocks; ++block) {
+    rows[block] = partial.data() + (size_t)block * cols_;
+  }
+  S21CombineRows(1.0, ones.data(), rows.data(), blocks, 0, result.Data(),
+                 cols_);
+  return result;
+}
+
+// Largest column sum of absolute values. The sums have no cancellation, so
+// they are plain running sums whatever the accumulation mode.
+double S21Matrix::Norm1() const {
+  std::vector<double> partial(ReductionBlocks(rows_, cols_) * (size_t)cols_);
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [this, &partial](int block, int first, int last) {
+        double *sums = partial.data() + (size_t)block * cols_;
+        for (int i = first; i < last; ++i) {
+          for (size_t j = 0; j < (size_t)cols_; ++j) {
+            sums[j] += fabs(matrix_[i][j]);
+          }
+        }
+      });
+  double result = 0.0;
+  for (size_t j = 0; j < (size_t)cols_; ++j) {
+    double sum = 0.0;
+    for (int block = 0; block < blocks; ++block) {
+      sum += partial[(size_t)block * cols_ + j];
+    }
+    result = std::max(result, sum);
+  }
+  return result;
+}
+
+// Largest row sum of absolute values, plain sums as in Norm1.
+double S21Matrix::NormInf() const {
+  std::vector<double> partial(ReductionBlocks(rows_, cols_));
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [this, &partial](int block, int first, int last) {
+        double largest = 0.0;
+        for (int i = first; i < last; ++i) {
+          double sum = 0.0;
+          for (size_t j = 0; j < (size_t)cols_; ++j) sum += fabs(matrix_[i][j]);
+          largest = std::max(largest, sum);
+        }
+        partial[block] = largest;
+      });
+  return *std::max_element(partial.begin(), partial.begin() + blocks);
+}
+
+// Sum of squares through S21Dot; only when that overflows or underflows to
+// zero is a second pass made with the elements scaled by the largest one.
+double S21Matrix::NormFro() const {
+  auto squares = [](const S21Matrix &matrix) {
+    std::vector<double> partial(ReductionBlocks(matrix.rows_, matrix.cols_));
+    int blocks = ForEachReductionBlock(
+        matrix.rows_, matrix.cols_,
+        [&matrix, &partial](int block, int first, int last) {
+          const double *data = matrix.matrix_[first];
+          size_t count = (size_t)(last - first) * matrix.cols_;
+          partial[block] = S21Dot(data, data, count);
+        });
+    return S21Sum(partial.data(), blocks);
+  };
+  double result = sqrt(squares(*this));
+  if (std::isfinite(result) && result > 0.0) return result;
+  double largest = std::max(fabs(Min()), fabs(Max()));
+  if (largest == 0.0 || !std::isfinite(largest)) return largest;
+  S21Matrix scaled(*this);
+  scaled.MulNumber(1.0 / largest);
+  return largest * sqrt(squares(scaled));
+}
+
+double S21Matrix::Min() const {
+  std::vector<double> partial(ReductionBlocks(rows_, cols_));
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [this, &partial](int block, int first, int last) {
+        const double *data = matrix_[first];
+        size_t count = (size_t)(last - first) * cols_;
+        partial[block] = *std::min_element(data, data + count);
+      });
+  return *std::min_element(partial.begin(), partial.begin() + blocks);
+}
+
+double S21Matrix::Max() const { return matrix_[0][ArgMaxOffset()]; }
+
+std::pair<int, int> S21Matrix::ArgMax() const {
+  size_t offset = ArgMaxOffset();
+  return {(int)(offset / cols_), (int)(offset % cols_)};
+}
+
+// Row-major offset of the first largest element, each block reporting its
+// own first maximum.
+size_t S21Matrix::ArgMaxOffset() const {
+  std::vector<size_t> partial(ReductionBlocks(rows_, cols_));
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [this, &partial](int block, int first, int last) {
+        const double *data = matrix_[first];
+        size_t count = (size_t)(last - first) * cols_;
+        partial[block] = (size_t)first * cols_ +
+                         (std::max_element(data, data + count) - data);
+      });
+  size_t result = partial[0];
+  for (int block = 1; block < blocks; ++block) {
+    if (matrix_[0][partial[block]] > matrix_[0][result]) {
+      result = partial[block];
+    }
+  }
+  return result;
+}
+
+S21Vector S21Matrix::Mean(S21Axis axis) const {
+  S21Vector result = axis == S21Axis::kRows ? RowSums() : ColSums();
+  result.MulNumber(1.0 / (axis == S21Axis::kRows ? cols_ : rows_));
+  return result;
+}
+
+S21Vector S21Matrix::Variance(S21Axis axis) const {
+  return Statistics(axis).variance;
+}
+
+// Per row, the row is summed and then its squared deviations are added
+// while it is still in cache. Per column, every block of rows runs Welford
+// updates across whole rows, and the block results are merged in order with
+// the pairwise formula of Chan, Golub and LeVeque.
+S21Statistics S21Matrix::Statistics(S21Axis axis) const {
+  if (axis == S21Axis::kRows) {
+    S21Statistics result{S21Vector(rows_), S21Vector(rows_)};
+    double *mean = result.mean.Data(), *variance = result.variance.Data();
+    ForEachRowBlock(rows_, cols_, [&](int first, int last) {
+      for (int i = first; i < last; ++i) {
+        mean[i] = S21Sum(matrix_[i], cols_) / cols_;
+        double squares = 0.0, deviations = 0.0;
+        for (size_t j = 0; j < (size_t)cols_; ++j) {
+          double deviation = matrix_[i][j] - mean[i];
+          squares += deviation * deviation;
+          deviations += deviation;
+        }
+        variance[i] = (squares - deviations * deviations / cols_) / cols_;
+      }
+    });
+    return result;
+  }
+
+  size_t cols = (size_t)cols_;
+  size_t partials = ReductionBlocks(rows_, cols_);
+  std::vector<double> means(partials * cols), squares(partials * cols);
+  std::vector<int> counts(partials);
+  int blocks = ForEachReductionBlock(
+      rows_, cols_, [&](int block, int first, int last) {
+        double *mean = means.data() + block * cols;
+        double *square = squares.data() + block * cols;
+        for (int i = first; i < last; ++i) {
+          double inverse = 1.0 / (i - first + 1);
+          for (size_t j = 0; j < cols; ++j) {
+            double delta = matrix_[i][j] - mean[j];
+            mean[j] += delta * inverse;
+            square[j] += delta * (matrix_[i][j] - mean[j]);
+          }
+        }
+        counts[block] = last - first;
+      });
+  S21Statistics result{S21Vector(cols_), S21Vector(cols_)};
+  double *mean = result.mean.Data(), *square = result.variance.Data();
+  std::copy(means.begin(), means.begin() + cols, mean);
+  std::copy(squares.begin(), squares.begin() + cols, square);
+  double count = counts[0];
+  for (int block = 1; block < blocks; ++block) {
+    double other = counts[block], total = count + other;
+    const double *other_mean = means.data() + block * cols;
+    const double *other_square = squares.data() + block * cols;
+    for (size_t j = 0; j < cols; ++j) {
+      double delta = other_mean[j] - mean[j];
+      mean[j] += delta * other / total;
+      square[j] += other_square[j] + delta * delta * count * other / total;
+    }
+    count = total;
+  }
+  S21Scale(1.0 / rows_, square, cols);
+  return result;
+}
+
 void S21Matrix::SetRows(const int rows) {
   if (rows < 1) {
     throw std::out_of_range(
@@ -1,58 +1,133 @@
 #ifndef CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_OOP_H_
 #define CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_OOP_H_
 
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 const double eps = 1e-7;
 
+class S21Vector;
+struct S21Statistics;
+
+// Direction of the per-axis reductions: kRows gives one value per row,
+// kCols one value per column.
+enum class S21Axis { kRows, kCols };
+
+// Tag for the constructor that leaves the elements unset. Meant for code
+// that writes every element before reading any of them.
+struct S21Uninitialized {};
+
+// Copies share one reference-counted buffer until either side is written,
+// so copying is O(1) and the buffer is duplicated on the first write. All
+// const members only read it, which makes them safe to call concurrently
+// from many threads on one matrix or on copies sharing its buffer, e.g. a
+// matrix used as the right operand of MulMatrix, Determinant, EqMatrix or
+// Transpose. Non-const members need exclusive access to their own object.
+// A reference from the non-const operator() is valid until the matrix is
+// copied or assigned; write through it before sharing the matrix.
 class S21Matrix {
+  friend class S21LazyMatrix;
+
  public:
   S21Matrix();
   S21Matrix(int rows, int cols);
+  S21Matrix(int rows, int cols, S21Uninitialized);
   S21Matrix(const S21Matrix& other);
   S21Matrix(S21Matrix&& other) noexcept;
   ~S21Matrix();
 
   double& operator()(int row, int col);
-  double& operator()(int row, int col) const;
+  const double& operator()(int row, int col) const;
 
   S21Matrix& operator=(const S21Matrix& other);
   S21Matrix& operator=(S21Matrix&& other) noexcept;
 
   S21Matrix& operator+=(const S21Matrix& other);
-  S21Matrix operator+(const S21Matrix& other);
+  S21Matrix operator+(const S21Matrix& other) const;
 
   S21Matrix& operator-=(const S21Matrix& other);
-  S21Matrix operator-(const S21Matrix& other);
+  S21Matrix operator-(const S21Matrix& other) const;
 
   friend S21Matrix operator*(double, S21Matrix&);
-  S21Matrix operator*(const S21Matrix& other);
+  S21Matrix operator*(const S21Matrix& other) const;
   S21Matrix& operator*=(const S21Matrix& other);
 
-  S21Matrix operator*(const double num);
+  S21Matrix operator*(const double num) const;
   S21Matrix& operator*=(const double num);
 
-  bool operator==(const S21Matrix& other);
+  bool operator==(const S21Matrix& other) const;
 
-  bool EqMatrix(const S21Matrix& other);
+  bool EqMatrix(const S21Matrix& other) const;
   void SumMatrix(const S21Matrix& other);
   void SubMatrix(const S21Matrix& other);
   void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
+  S21Matrix Transpose() const;
+  S21Matrix CalcComplements() const;
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+  S21Matrix Solve(const S21Matrix& rhs) const;
+  S21Vector MulVector(const S21Vector& x) const;
+  void MulVector(const S21Vector& x, S21Vector& y, double alpha = 1.0,
+                 double beta = 0.0) const;
+  S21Vector MulVectorTransposed(const S21Vector& x) const;
+  void MulVectorTransposed(const S21Vector& x, S21Vector& y,
+                           double alpha = 1.0, double beta = 0.0) const;
+  void RankOneUpdate(double alpha, const S21Vector& x, const S21Vector& y);
+  void RankKUpdate(double alpha, const S21Matrix& a, double beta = 1.0);
+  int Rank() const;
+  // Gaussian elimination with full pivoting. Row i and column j of the
+  // result come from row row_perm[i] and column col_perm[j]; U is on and
+  // above the diagonal and the multipliers of the unit lower L below it,
+  // and sign is the parity of both permutations. The first pivot below a
+  // relative tolerance stops the elimination and gives the numerical rank.
+  // Throws std::runtime_error between elimination steps once `cancelled`
+  // is set.
+  S21Matrix DecomposeLU(std::vector<int>& row_perm, std::vector<int>& col_perm,
+                        int& sign, int& rank,
+                        const std::atomic<bool>* cancelled = nullptr) const;
+  double ConditionNumber() const;
+  S21Matrix PseudoInverse() const;
+  S21Matrix Pow(int power) const;
+  S21Matrix Exp() const;
+
+  double Sum() const;
+  S21Vector RowSums() const;
+  S21Vector ColSums() const;
+  double Norm1() const;
+  double NormInf() const;
+  double NormFro() const;
+  double Min() const;
+  double Max() const;
+  // (row, col) of the first largest element in row-major order.
+  std::pair<int, int> ArgMax() const;
+  S21Vector Mean(S21Axis axis) const;
+  S21Vector Variance(S21Axis axis) const;
+  // Mean and variance along one axis from a single pass over the matrix.
+  S21Statistics Statistics(S21Axis axis) const;
 
-  int GetRows() { return rows_; };
+  int GetRows() const { return rows_; };
   void SetRows(const int rows);
 
-  int GetCols() { return cols_; };
+  int GetCols() const { return cols_; };
   void SetCols(const int cols);
 
  private:
   int rows_, cols_;
   double** matrix_;
-  void Create(int rows, int cols);
-  S21Matrix Minor(int row, int col);
+  // Owners of matrix_, shared by all copies; null once moved from.
+  std::atomic<int>* refs_;
+  void Create(int rows, int cols, bool zero = true);
+  void Destroy();
+  void Detach();
+  S21Matrix Minor(int row, int col) const;
+  S21Matrix ComplementsByMinors() const;
+  S21Matrix ComplementsByLU() const;
+  size_t ArgMaxOffset() const;
+  static void Multiply(const S21Matrix& left, const S21Matrix& right,
+                       S21Matrix& result);
 };
 
 #endif  // CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_OOP_H_
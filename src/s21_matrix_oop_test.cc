@@ -1,9 +1,30 @@
 #include "s21_matrix_oop.h"
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <thread>
 
 #include "gtest/gtest.h"
+#include "s21_convolution.h"
+#include "s21_lazy_matrix.h"
+#include "s21_matrix_async.h"
+#include "s21_kernels.h"
+#include "s21_matrix_decomposition.h"
+#include "s21_matrix_server.h"
+#include "s21_numa.h"
+#include "s21_structured_matrix.h"
+#include "s21_tiled_matrix.h"
+#include "s21_vector.h"
 
 void print_matrix(S21Matrix& matrix) {
   std::cout << "\nSTART\n";
@@ -33,6 +54,26 @@ void FillingMatrixNumber(S21Matrix& matrix, double num) {
   }
 }
 
+S21Matrix ComplementsByMinors(S21Matrix& matrix) {
+  int size = matrix.GetRows();
+  S21Matrix result(size, size);
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      S21Matrix minor(size - 1, size - 1);
+      for (int r = 0, mr = 0; r < size; ++r) {
+        if (r == i) continue;
+        for (int c = 0, mc = 0; c < size; ++c) {
+          if (c == j) continue;
+          minor(mr, mc++) = matrix(r, c);
+        }
+        ++mr;
+      }
+      result(i, j) = ((i + j) % 2 ? -1.0 : 1.0) * minor.Determinant();
+    }
+  }
+  return result;
+}
+
 TEST(constructor, basic) {
   S21Matrix matrix1;
   EXPECT_EQ(matrix1.GetCols(), 1);
@@ -381,6 +422,60 @@ TEST(calc_complements_suite, exception) {
   EXPECT_THROW(matrix1.CalcComplements(), std::invalid_argument);
 }
 
+TEST(calc_complements_suite, lu_matches_minors) {
+  for (int size = 4; size <= 7; ++size) {
+    S21Matrix matrix1(size, size);
+    for (int i = 0; i < size; ++i) {
+      for (int j = 0; j < size; ++j) {
+        matrix1(i, j) = ((i * 7 + j * 3) % 11) - 5.0 + (i == j ? size : 0);
+      }
+    }
+    S21Matrix expected = ComplementsByMinors(matrix1);
+    EXPECT_TRUE(matrix1.CalcComplements() == expected);
+  }
+}
+
+TEST(calc_complements_suite, lu_rank_deficient) {
+  S21Matrix matrix1(4, 4);
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      matrix1(i, j) = i * 4 + j + 1;
+    }
+  }
+  S21Matrix zero(4, 4);
+  EXPECT_TRUE(matrix1.CalcComplements() == zero);
+
+  S21Matrix matrix2(4, 4);
+  matrix2(0, 0) = 2.0;
+  matrix2(0, 1) = 1.0;
+  matrix2(1, 1) = 3.0;
+  matrix2(1, 2) = 1.0;
+  matrix2(2, 2) = 4.0;
+  matrix2(2, 3) = 1.0;
+  for (int j = 0; j < 4; ++j) {
+    matrix2(3, j) = matrix2(0, j) + matrix2(2, j);
+  }
+  S21Matrix expected = ComplementsByMinors(matrix2);
+  EXPECT_TRUE(matrix2.CalcComplements() == expected);
+  EXPECT_FALSE(expected == zero);
+}
+
+TEST(calc_complements_suite, lu_adjugate_identity) {
+  S21Matrix matrix1(6, 6);
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      matrix1(i, j) = 1.0 / (i + j + 1) + (i == j ? 1.0 : 0.0);
+    }
+  }
+  S21Matrix product = matrix1 * matrix1.CalcComplements().Transpose();
+  double det = matrix1.Determinant();
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      EXPECT_NEAR(product(i, j), i == j ? det : 0.0, 1e-9);
+    }
+  }
+}
+
 TEST(determinant_suite, basic_2_2) {
   S21Matrix matrix2(2, 2);
   matrix2(0, 0) = 1.0;
@@ -426,6 +521,51 @@ TEST(determinant_suite, exception) {
   EXPECT_THROW(matrix4.Determinant(), std::invalid_argument);
 }
 
+TEST(determinant_suite, lu_5_5) {
+  S21Matrix matrix1(5, 5);
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      matrix1(i, j) = (i + 1) * (j + 2) % 7 + (i == j ? 3.0 : 0.0);
+    }
+  }
+  double expected = 0.0;
+  for (int j = 0; j < 5; ++j) {
+    S21Matrix minor(4, 4);
+    for (int r = 1; r < 5; ++r) {
+      for (int c = 0, mc = 0; c < 5; ++c) {
+        if (c != j) minor(r - 1, mc++) = matrix1(r, c);
+      }
+    }
+    S21Matrix cofactors = ComplementsByMinors(minor);
+    double minor_det = 0.0;
+    for (int c = 0; c < 4; ++c) minor_det += minor(0, c) * cofactors(0, c);
+    expected += (j % 2 ? -1.0 : 1.0) * matrix1(0, j) * minor_det;
+  }
+  EXPECT_NEAR(matrix1.Determinant(), expected, 1e-9);
+}
+
+TEST(solve_suite, basic) {
+  S21Matrix matrix1(4, 4);
+  S21Matrix expected(4, 2);
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      matrix1(i, j) = (i * 3 + j * 5) % 7 + (i == j ? 4.0 : 0.0);
+    }
+    expected(i, 0) = i + 1.0;
+    expected(i, 1) = 2.0 - i;
+  }
+  S21Matrix rhs = matrix1 * expected;
+  EXPECT_TRUE(matrix1.Solve(rhs) == expected);
+}
+
+TEST(solve_suite, exception) {
+  S21Matrix matrix1(4, 4);
+  S21Matrix rhs(4, 1);
+  EXPECT_THROW(matrix1.Solve(rhs), std::invalid_argument);
+  S21Matrix wrong_rhs(3, 1);
+  EXPECT_THROW(matrix1.Solve(wrong_rhs), std::out_of_range);
+}
+
 TEST(inverse_matrix_suite, exception) {
   S21Matrix matrix1(2, 2);
   FillingMatrixNumber(matrix1, 1);
@@ -645,6 +785,1118 @@ TEST(overloads, indexation_exception) {
   EXPECT_THROW(matrix1(4, 1), std::out_of_range);
 }
 
+S21Matrix SymmetricTestMatrix(int size) {
+  S21Matrix result(size, size);
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      result(i, j) = 1.0 / (i + j + 1) + (i == j ? size : 0.0);
+    }
+  }
+  return result;
+}
+
+TEST(symmetric_matrix_suite, conversion) {
+  S21Matrix dense = SymmetricTestMatrix(5);
+  S21SymmetricMatrix packed(dense);
+  EXPECT_TRUE(packed.ToMatrix() == dense);
+  packed(3, 1) = 7.0;
+  EXPECT_EQ(packed(1, 3), 7.0);
+  EXPECT_THROW(packed(5, 0), std::out_of_range);
+
+  dense(0, 1) += 1.0;
+  EXPECT_THROW(S21SymmetricMatrix{dense}, std::invalid_argument);
+}
+
+TEST(symmetric_matrix_suite, kernels) {
+  S21Matrix dense = SymmetricTestMatrix(6);
+  S21SymmetricMatrix packed(dense);
+  S21Matrix other(6, 3);
+  FillingMatrixRandom(other);
+
+  EXPECT_TRUE(packed.MulMatrix(other) == dense * other);
+  EXPECT_TRUE(packed.Transpose().ToMatrix() == dense.Transpose());
+  EXPECT_NEAR(packed.Determinant(), dense.Determinant(), 1e-6);
+  EXPECT_TRUE(packed.Solve(other) == dense.Solve(other));
+}
+
+TEST(symmetric_matrix_suite, indefinite_fallback) {
+  S21SymmetricMatrix packed(3);
+  packed(0, 1) = 1.0;
+  packed(1, 2) = 2.0;
+  packed(2, 2) = 1.0;
+  EXPECT_NEAR(packed.Determinant(), packed.ToMatrix().Determinant(), eps);
+  S21Matrix rhs(3, 1);
+  FillingMatrixNumber(rhs, 1.0);
+  EXPECT_TRUE(packed.MulMatrix(packed.Solve(rhs)) == rhs);
+
+  // Small but nonzero pivots of an indefinite matrix would blow up the
+  // unpivoted factors.
+  S21SymmetricMatrix small_pivot(2);
+  small_pivot(0, 0) = 1.3e-13;
+  small_pivot(0, 1) = 0.7;
+  small_pivot(1, 1) = 0.3;
+  S21Matrix small_rhs(2, 1);
+  small_rhs(0, 0) = 0.1;
+  small_rhs(1, 0) = 0.9;
+  EXPECT_TRUE(small_pivot.MulMatrix(small_pivot.Solve(small_rhs)) ==
+              small_rhs);
+  EXPECT_NEAR(small_pivot.Determinant(),
+              small_pivot.ToMatrix().Determinant(), eps);
+}
+
+TEST(triangular_matrix_suite, kernels) {
+  for (bool upper : {true, false}) {
+    S21TriangularMatrix packed(5, upper);
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        if (upper ? i <= j : i >= j) packed(i, j) = (i * 2 + j) % 5 + 1.0;
+      }
+    }
+    S21Matrix dense = packed.ToMatrix();
+    S21Matrix other(5, 2);
+    FillingMatrixRandom(other);
+
+    EXPECT_TRUE(S21TriangularMatrix(dense, upper).ToMatrix() == dense);
+    EXPECT_TRUE(packed.MulMatrix(other) == dense * other);
+    EXPECT_TRUE(packed.Transpose().ToMatrix() == dense.Transpose());
+    EXPECT_EQ(packed.Transpose().IsUpper(), !upper);
+    EXPECT_NEAR(packed.Determinant(), dense.Determinant(), 1e-9);
+    EXPECT_TRUE(packed.Solve(other) == dense.Solve(other));
+  }
+}
+
+TEST(triangular_matrix_suite, exception) {
+  S21TriangularMatrix packed(3, true);
+  EXPECT_THROW(packed(2, 0), std::out_of_range);
+  EXPECT_EQ(static_cast<const S21TriangularMatrix&>(packed)(2, 0), 0.0);
+  S21Matrix rhs(3, 1);
+  EXPECT_THROW(packed.Solve(rhs), std::invalid_argument);
+  S21Matrix dense(3, 3);
+  dense(2, 0) = 1.0;
+
+  // 0.5^2000 underflows to 0 but the system is fine; a pivot that is only
+  // rounding noise next to the others is not.
+  S21TriangularMatrix scaled(2000, false);
+  for (int i = 0; i < 2000; ++i) scaled(i, i) = 0.5;
+  EXPECT_TRUE(scaled.Solve(S21Matrix(2000, 1)) == S21Matrix(2000, 1));
+  scaled(1000, 1000) = 1e-30;
+  EXPECT_THROW(scaled.Solve(S21Matrix(2000, 1)), std::invalid_argument);
+  EXPECT_THROW(S21TriangularMatrix(dense, true), std::invalid_argument);
+}
+
+TEST(band_matrix_suite, kernels) {
+  S21BandMatrix band(8, 2, 1);
+  for (int i = 0; i < 8; ++i) {
+    for (int j = std::max(0, i - 2); j <= std::min(7, i + 1); ++j) {
+      band(i, j) = (i * 3 + j * 5) % 7 - 3.0;
+    }
+  }
+  S21Matrix dense = band.ToMatrix();
+  S21Matrix other(8, 3);
+  FillingMatrixRandom(other);
+
+  EXPECT_TRUE(S21BandMatrix(dense, 2, 1).ToMatrix() == dense);
+  EXPECT_TRUE(band.MulMatrix(other) == dense * other);
+  EXPECT_TRUE(band.Transpose().ToMatrix() == dense.Transpose());
+  EXPECT_NEAR(band.Determinant(), dense.Determinant(), 1e-6);
+  EXPECT_TRUE(band.Solve(other) == dense.Solve(other));
+}
+
+TEST(band_matrix_suite, exception) {
+  S21BandMatrix band(4, 1, 1);
+  EXPECT_THROW(band(3, 0), std::out_of_range);
+  EXPECT_THROW(S21BandMatrix(4, 4, 0), std::out_of_range);
+  EXPECT_EQ(band.Determinant(), 0.0);
+  S21Matrix rhs(4, 1);
+  EXPECT_THROW(band.Solve(rhs), std::invalid_argument);
+}
+
+// Scratch file in the system temporary directory, unique to this process.
+std::string TempPath(const std::string& name) {
+  return (std::filesystem::temp_directory_path() /
+          ("s21_" + std::to_string(getpid()) + "_" + name))
+      .string();
+}
+
+S21Matrix TiledTestMatrix(int rows, int cols) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      result(i, j) = (i * 5 + j * 3) % 11 - 5.0 + (i == j ? 9.0 : 0.0);
+    }
+  }
+  return result;
+}
+
+TEST(tiled_matrix_suite, conversion) {
+  S21Matrix dense = TiledTestMatrix(7, 5);
+  {
+    S21TiledMatrix tiled(TempPath("tiled_a.bin"), dense, 3, 3);
+    EXPECT_TRUE(tiled.ToMatrix() == dense);
+    tiled(6, 4) = 42.0;
+    EXPECT_EQ(tiled(6, 4), 42.0);
+    EXPECT_THROW(tiled(7, 0), std::out_of_range);
+  }
+  EXPECT_THROW(S21TiledMatrix(TempPath("tiled_a.bin"), 2, 2, 1, 2),
+               std::invalid_argument);
+  std::remove(TempPath("tiled_a.bin").c_str());
+}
+
+TEST(tiled_matrix_suite, element_wise) {
+  S21Matrix dense1 = TiledTestMatrix(7, 8);
+  S21Matrix dense2 = dense1.Transpose().Transpose() * 2.0;
+  {
+    S21TiledMatrix tiled1(TempPath("tiled_a.bin"), dense1, 3, 3);
+    S21TiledMatrix tiled2(TempPath("tiled_b.bin"), dense2, 3, 4);
+    tiled1.SumMatrix(tiled2);
+    EXPECT_TRUE(tiled1.ToMatrix() == dense1 + dense2);
+    tiled1.SubMatrix(tiled2);
+    tiled1.MulNumber(3.0);
+    EXPECT_TRUE(tiled1.ToMatrix() == dense1 * 3.0);
+
+    S21TiledMatrix wrong(TempPath("tiled_c.bin"), 7, 8, 2, 3);
+    EXPECT_THROW(tiled1.SumMatrix(wrong), std::invalid_argument);
+  }
+  std::remove(TempPath("tiled_a.bin").c_str());
+  std::remove(TempPath("tiled_b.bin").c_str());
+  std::remove(TempPath("tiled_c.bin").c_str());
+}
+
+TEST(tiled_matrix_suite, mul_transpose) {
+  S21Matrix dense1 = TiledTestMatrix(7, 5);
+  S21Matrix dense2 = TiledTestMatrix(5, 8);
+  {
+    S21TiledMatrix tiled1(TempPath("tiled_a.bin"), dense1, 2, 3);
+    S21TiledMatrix tiled2(TempPath("tiled_b.bin"), dense2, 2, 3);
+    S21TiledMatrix product = tiled1.MulMatrix(tiled2, TempPath("tiled_c.bin"));
+    EXPECT_TRUE(product.ToMatrix() == dense1 * dense2);
+    S21TiledMatrix transposed = tiled1.Transpose(TempPath("tiled_d.bin"));
+    EXPECT_TRUE(transposed.ToMatrix() == dense1.Transpose());
+    EXPECT_THROW(tiled1.MulMatrix(tiled1, TempPath("tiled_e.bin")),
+                 std::out_of_range);
+  }
+  for (const char* name : {"tiled_a.bin", "tiled_b.bin", "tiled_c.bin",
+                           "tiled_d.bin", "tiled_e.bin"}) {
+    std::remove(TempPath(name).c_str());
+  }
+}
+
+TEST(tiled_matrix_suite, decompose_lu) {
+  // The second size has tile columns longer than the cache.
+  for (int size : {8, 20}) {
+    S21Matrix dense = TiledTestMatrix(size, size);
+    dense(0, 0) = 0.0;
+    std::vector<int> pivots;
+    S21Matrix packed;
+    {
+      S21TiledMatrix tiled(TempPath("tiled_a.bin"), dense, 3, 3);
+      pivots = tiled.DecomposeLU();
+      packed = tiled.ToMatrix();
+    }
+    std::remove(TempPath("tiled_a.bin").c_str());
+
+    S21Matrix lower(size, size), upper(size, size);
+    for (int i = 0; i < size; ++i) {
+      for (int j = 0; j < size; ++j) {
+        if (i > j) lower(i, j) = packed(i, j);
+        if (i <= j) upper(i, j) = packed(i, j);
+      }
+      lower(i, i) = 1.0;
+    }
+    S21Matrix permuted(dense);
+    for (int i = 0; i < size; ++i) {
+      for (int j = 0; j < size; ++j) {
+        std::swap(permuted(i, j), permuted(pivots[i], j));
+      }
+    }
+    EXPECT_TRUE(lower * upper == permuted);
+  }
+}
+
+TEST(thread_pool_suite, parallel_for) {
+  S21ThreadPool pool(4);
+  std::vector<int> hits(1000, 0);
+  pool.ParallelFor(0, 1000, 10, [&hits](int first, int last) {
+    for (int i = first; i < last; ++i) ++hits[i];
+  });
+  EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1000);
+  EXPECT_THROW(pool.ParallelFor(0, 100, 1,
+                                [](int first, int) {
+                                  if (first > 50) throw std::out_of_range("");
+                                }),
+               std::out_of_range);
+}
+
+TEST(async_suite, chain) {
+  S21Matrix dense1 = TiledTestMatrix(5, 5);
+  S21Matrix dense2 = TiledTestMatrix(5, 5).Transpose();
+  S21AsyncMatrix matrix1(dense1);
+  S21AsyncMatrix matrix2 = S21AsyncMatrix::Launch([&dense2]() {
+    return dense2;
+  });
+
+  S21AsyncMatrix result =
+      matrix1.MulMatrix(matrix2).Transpose().SumMatrix(matrix1).MulNumber(
+          2.0);
+  S21Matrix expected = ((dense1 * dense2).Transpose() + dense1) * 2.0;
+  EXPECT_TRUE(result.Get() == expected);
+  EXPECT_TRUE(result.IsReady());
+
+  S21AsyncMatrix solved = matrix1.Solve(matrix2);
+  EXPECT_TRUE(dense1 * solved.Get() == dense2);
+  EXPECT_TRUE(matrix1.InverseMatrix().Get() == dense1.InverseMatrix());
+  EXPECT_NEAR(matrix1.Determinant().Get(), dense1.Determinant(), 1e-6);
+  EXPECT_TRUE(matrix1.Then([](const S21Matrix& m) { return m * 3.0; })
+                  .SubMatrix(matrix1)
+                  .GetFuture()
+                  .get() == dense1 * 2.0);
+}
+
+TEST(async_suite, exception) {
+  S21AsyncMatrix matrix1(S21Matrix(2, 3));
+  S21AsyncMatrix product = matrix1.MulMatrix(matrix1);
+  S21AsyncMatrix dependent = product.Transpose();
+  EXPECT_THROW(product.Get(), std::out_of_range);
+  EXPECT_THROW(dependent.Get(), std::out_of_range);
+  EXPECT_THROW(dependent.Determinant().Get(), std::out_of_range);
+}
+
+TEST(async_suite, cancel) {
+  S21ThreadPool pool(1);
+  std::promise<void> gate;
+  std::shared_future<void> opened = gate.get_future().share();
+  S21AsyncMatrix blocker = S21AsyncMatrix::Launch(
+      [opened]() {
+        opened.wait();
+        return S21Matrix(2, 2);
+      },
+      pool);
+  S21AsyncMatrix cancelled = blocker.Transpose();
+  S21AsyncMatrix dependent = cancelled.MulNumber(2.0);
+  cancelled.Cancel();
+  gate.set_value();
+
+  EXPECT_TRUE(blocker.Get() == S21Matrix(2, 2));
+  EXPECT_THROW(cancelled.Get(), std::runtime_error);
+  EXPECT_THROW(dependent.Get(), std::runtime_error);
+}
+
+TEST(async_suite, cancel_determinant) {
+  S21Matrix matrix(1500, 1500);
+  FillingMatrixRandom(matrix);
+  for (int i = 0; i < matrix.GetRows(); ++i) matrix(i, i) += 50.0;
+  S21ThreadPool pool(1);
+  S21AsyncMatrix source(matrix, pool);
+
+  auto start = std::chrono::steady_clock::now();
+  S21AsyncValue determinant = source.Determinant();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  determinant.Cancel();
+  EXPECT_THROW(determinant.Get(), std::runtime_error);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+  // Cancelling one request leaves the handle and its other requests alone.
+  S21AsyncMatrix small(TiledTestMatrix(5, 5), pool);
+  S21AsyncValue cancelled = small.Determinant();
+  S21AsyncValue kept = small.Determinant();
+  cancelled.Cancel();
+  EXPECT_NEAR(kept.Get(), TiledTestMatrix(5, 5).Determinant(), 1e-6);
+  EXPECT_NEAR(small.Determinant().Get(), kept.Get(), 1e-6);
+  EXPECT_TRUE(small.Get() == TiledTestMatrix(5, 5));
+}
+
+TEST(lazy_suite, mixed_expression) {
+  S21Matrix a = TiledTestMatrix(4, 6);
+  S21Matrix b = TiledTestMatrix(6, 3);
+  S21Matrix c = TiledTestMatrix(4, 5);
+  S21Matrix d = TiledTestMatrix(3, 5);
+
+  S21LazyMatrix lazy_a(a), lazy_b(b), lazy_c(c), lazy_d(d);
+  S21LazyMatrix expression =
+      (lazy_a * lazy_b).Transpose() * lazy_c + lazy_d * 2.0;
+  EXPECT_EQ(expression.GetRows(), 3);
+  EXPECT_EQ(expression.GetCols(), 5);
+  EXPECT_TRUE(expression.Evaluate() == (a * b).Transpose() * c + d * 2.0);
+}
+
+TEST(lazy_suite, chains_and_nested_sums) {
+  S21Matrix a = TiledTestMatrix(10, 2);
+  S21Matrix b = TiledTestMatrix(2, 9);
+  S21Matrix c = TiledTestMatrix(9, 3);
+  S21Matrix d = TiledTestMatrix(3, 10);
+  S21LazyMatrix lazy_a(a), lazy_b(b), lazy_c(c), lazy_d(d);
+
+  EXPECT_TRUE((lazy_a * lazy_b * lazy_c * lazy_d).Evaluate() ==
+              a * b * c * d);
+  S21LazyMatrix square = lazy_a * lazy_b * lazy_c * lazy_d;
+  EXPECT_TRUE(((square - square.Transpose()) * lazy_a * 0.5).Evaluate() ==
+              (a * b * c * d - (a * b * c * d).Transpose()) * a * 0.5);
+  EXPECT_TRUE((2.0 * (lazy_b.Transpose() + lazy_b.Transpose())).Evaluate() ==
+              b.Transpose() * 4.0);
+  EXPECT_TRUE(lazy_a.Transpose().Evaluate() == a.Transpose());
+}
+
+TEST(lazy_suite, shared_subexpressions) {
+  S21Matrix a = TiledTestMatrix(3, 3), identity(3, 3);
+  for (int i = 0; i < 3; ++i) identity(i, i) = 1.0;
+  // Both graphs have 2^40 paths, so only evaluating each node once ends.
+  S21LazyMatrix doubled(a), squared(identity);
+  for (int i = 0; i < 40; ++i) {
+    doubled = doubled + doubled;
+    squared = squared * squared.Transpose();
+  }
+  EXPECT_TRUE(doubled.Evaluate() == a * std::pow(2.0, 40));
+  EXPECT_TRUE(squared.Evaluate() == identity);
+
+  S21LazyMatrix product = S21LazyMatrix(a) * S21LazyMatrix(a);
+  EXPECT_TRUE((product.Transpose() * product + product).Evaluate() ==
+              (a * a).Transpose() * (a * a) + a * a);
+}
+
+TEST(lazy_suite, products_match_eager) {
+  S21Matrix a = TiledTestMatrix(40, 30), b = TiledTestMatrix(30, 40);
+  S21LazyMatrix lazy_a(a), lazy_b(b);
+  // Small integer entries, so every summation order agrees bit for bit.
+  auto same = [](const S21Matrix& x, const S21Matrix& y) {
+    if (x.GetRows() != y.GetRows() || x.GetCols() != y.GetCols()) return false;
+    for (int i = 0; i < x.GetRows(); ++i) {
+      for (int j = 0; j < x.GetCols(); ++j) {
+        if (x(i, j) != y(i, j)) return false;
+      }
+    }
+    return true;
+  };
+  EXPECT_TRUE(same((lazy_a * lazy_b).Evaluate(), a * b));
+  EXPECT_TRUE(same((lazy_b.Transpose() * lazy_b).Evaluate(),
+                   b.Transpose() * b));
+  EXPECT_TRUE(same((lazy_a * lazy_a.Transpose()).Evaluate(),
+                   a * a.Transpose()));
+  EXPECT_TRUE(same((lazy_b.Transpose() * lazy_a.Transpose()).Evaluate(),
+                   (a * b).Transpose()));
+}
+
+TEST(lazy_suite, exception) {
+  S21LazyMatrix lazy_a(S21Matrix(2, 3));
+  EXPECT_THROW(lazy_a * lazy_a, std::out_of_range);
+  EXPECT_THROW(lazy_a + lazy_a.Transpose(), std::out_of_range);
+  EXPECT_THROW(lazy_a - lazy_a.Transpose(), std::out_of_range);
+}
+
+TEST(eigen_suite, reconstruction) {
+  for (int size : {1, 2, 5, 70}) {
+    S21Matrix matrix = SymmetricTestMatrix(size) - S21Matrix(size, size);
+    for (int i = 0; i < size; ++i) matrix(i, i) -= 1.5 * size;
+    S21SymmetricEigen eigen = S21EigenSymmetric(matrix);
+    S21Matrix values(size, size);
+    for (int i = 0; i < size; ++i) {
+      values(i, i) = eigen.values[i];
+      if (i > 0) {
+        EXPECT_LE(eigen.values[i - 1], eigen.values[i]);
+      }
+    }
+    S21Matrix identity(size, size);
+    for (int i = 0; i < size; ++i) identity(i, i) = 1.0;
+    EXPECT_TRUE(eigen.vectors * values * eigen.vectors.Transpose() == matrix);
+    EXPECT_TRUE(eigen.vectors.Transpose() * eigen.vectors == identity);
+  }
+}
+
+TEST(eigen_suite, exception) {
+  S21Matrix matrix(3, 3);
+  matrix(0, 2) = 1.0;
+  EXPECT_THROW(S21EigenSymmetric(matrix), std::invalid_argument);
+  EXPECT_THROW(S21EigenSymmetric(S21Matrix(2, 3)), std::invalid_argument);
+}
+
+TEST(svd_suite, reconstruction) {
+  for (auto shape : {std::make_pair(6, 4), std::make_pair(3, 7),
+                     std::make_pair(80, 45), std::make_pair(1, 1)}) {
+    S21Matrix matrix = TiledTestMatrix(shape.first, shape.second);
+    S21SingularValues svd = S21SingularValueDecomposition(matrix);
+    int k = std::min(shape.first, shape.second);
+    EXPECT_EQ(svd.u.GetRows(), shape.first);
+    EXPECT_EQ(svd.u.GetCols(), k);
+    EXPECT_EQ(svd.v.GetRows(), shape.second);
+    EXPECT_EQ(svd.v.GetCols(), k);
+    S21Matrix sigma(k, k);
+    for (int i = 0; i < k; ++i) {
+      sigma(i, i) = svd.singular[i];
+      if (i > 0) {
+        EXPECT_GE(svd.singular[i - 1], svd.singular[i]);
+      }
+    }
+    EXPECT_TRUE(svd.u * sigma * svd.v.Transpose() == matrix);
+  }
+}
+
+TEST(svd_suite, rank_condition_pseudo_inverse) {
+  S21Matrix diagonal(3, 3);
+  diagonal(0, 0) = 1.0;
+  diagonal(1, 1) = -10.0;
+  diagonal(2, 2) = 4.0;
+  EXPECT_NEAR(diagonal.ConditionNumber(), 10.0, 1e-9);
+  EXPECT_EQ(diagonal.Rank(), 3);
+  EXPECT_TRUE(diagonal.PseudoInverse() == diagonal.InverseMatrix());
+
+  S21Matrix deficient(5, 4);
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 4; ++j) deficient(i, j) = (i + 1) * (j + 2) + j;
+  }
+  EXPECT_EQ(deficient.Rank(), 2);
+  EXPECT_GT(deficient.ConditionNumber(), 1e12);
+  S21Matrix pinv = deficient.PseudoInverse();
+  EXPECT_EQ(pinv.GetRows(), 4);
+  EXPECT_EQ(pinv.GetCols(), 5);
+  EXPECT_TRUE(deficient * pinv * deficient == deficient);
+  EXPECT_TRUE(pinv * deficient * pinv == pinv);
+}
+
+S21Matrix Identity(int size) {
+  S21Matrix result(size, size);
+  for (int i = 0; i < size; ++i) result(i, i) = 1.0;
+  return result;
+}
+
+TEST(qr_suite, reconstruction) {
+  for (auto shape : {std::make_pair(7, 4), std::make_pair(4, 7),
+                     std::make_pair(100, 70), std::make_pair(1, 1)}) {
+    S21Matrix matrix = TiledTestMatrix(shape.first, shape.second);
+    S21QR qr = S21QRDecomposition(matrix);
+    int k = std::min(shape.first, shape.second);
+    EXPECT_EQ(qr.q.GetCols(), k);
+    EXPECT_EQ(qr.r.GetRows(), k);
+    EXPECT_TRUE(qr.q * qr.r == matrix);
+    EXPECT_TRUE(qr.q.Transpose() * qr.q == Identity(k));
+    for (int i = 0; i < k; ++i) {
+      for (int j = 0; j < i; ++j) EXPECT_EQ(qr.r(i, j), 0.0);
+    }
+  }
+}
+
+TEST(least_squares_suite, basic) {
+  S21Matrix a = TiledTestMatrix(90, 40);
+  S21Matrix b = TiledTestMatrix(90, 2);
+  S21Matrix x = S21LeastSquares(a, b);
+  S21Matrix normal = a.Transpose() * a;
+  EXPECT_TRUE(x == normal.Solve(a.Transpose() * b));
+
+  S21Matrix square = TiledTestMatrix(5, 5);
+  S21Matrix rhs = TiledTestMatrix(5, 1);
+  EXPECT_TRUE(S21LeastSquares(square, rhs) == square.Solve(rhs));
+}
+
+TEST(least_squares_suite, exception) {
+  EXPECT_THROW(S21LeastSquares(S21Matrix(2, 3), S21Matrix(2, 1)),
+               std::invalid_argument);
+  EXPECT_THROW(S21LeastSquares(S21Matrix(3, 2), S21Matrix(2, 1)),
+               std::out_of_range);
+  S21Matrix deficient(4, 2);
+  for (int i = 0; i < 4; ++i) deficient(i, 0) = deficient(i, 1) = i + 1.0;
+  EXPECT_THROW(S21LeastSquares(deficient, S21Matrix(4, 1)),
+               std::invalid_argument);
+}
+
+TEST(least_squares_suite, streaming) {
+  S21Matrix a = TiledTestMatrix(700, 6);
+  S21Matrix b = TiledTestMatrix(700, 2);
+  S21StreamingQR streaming(6, 2);
+  EXPECT_THROW(streaming.Solve(), std::invalid_argument);
+  for (int first = 0; first < 700; first += 350) {
+    S21Matrix rows(350, 6), rhs(350, 2);
+    for (int i = 0; i < 350; ++i) {
+      for (int j = 0; j < 6; ++j) rows(i, j) = a(first + i, j);
+      for (int j = 0; j < 2; ++j) rhs(i, j) = b(first + i, j);
+    }
+    streaming.AddRows(rows, rhs);
+  }
+  EXPECT_TRUE(streaming.Solve() == S21LeastSquares(a, b));
+  S21Matrix r = streaming.GetR();
+  EXPECT_TRUE(r.Transpose() * r == a.Transpose() * a);
+  EXPECT_THROW(streaming.AddRows(S21Matrix(3, 5), S21Matrix(3, 2)),
+               std::out_of_range);
+
+  // One block of many chunks, merged per thread and then in a tree.
+  S21Matrix tall = TiledTestMatrix(5000, 12), tall_rhs(5000, 3);
+  for (int i = 0; i < 5000; ++i) {
+    for (int j = 0; j < 3; ++j) tall_rhs(i, j) = std::sin(i + 7.0 * j);
+  }
+  S21StreamingQR single(12, 3);
+  single.AddRows(tall, tall_rhs);
+  EXPECT_TRUE(single.Solve() == S21LeastSquares(tall, tall_rhs));
+}
+
+S21Vector VectorTestData(int size) {
+  S21Vector result(size);
+  for (int i = 0; i < size; ++i) result(i) = (i * 7) % 13 - 6.0;
+  return result;
+}
+
+TEST(vector_suite, basic) {
+  S21Vector x = VectorTestData(10), y = VectorTestData(10);
+  y.MulNumber(2.0);
+  x.Axpy(3.0, y);
+  S21Vector expected = VectorTestData(10);
+  expected.MulNumber(7.0);
+  EXPECT_TRUE(x == expected);
+  EXPECT_DOUBLE_EQ(x.Dot(y), (x.ToMatrix().Transpose() * y.ToMatrix())(0, 0));
+  EXPECT_TRUE(S21Vector(x.ToMatrix().Transpose()) == x);
+  EXPECT_THROW(x.Dot(S21Vector(3)), std::out_of_range);
+  EXPECT_THROW(x(10), std::out_of_range);
+  EXPECT_THROW(S21Vector(S21Matrix(2, 2)), std::invalid_argument);
+}
+
+TEST(gemv_suite, mul_vector) {
+  S21Matrix matrix = TiledTestMatrix(300, 201);
+  S21Vector x = VectorTestData(201), y = VectorTestData(300);
+  EXPECT_TRUE(matrix.MulVector(x) == S21Vector(matrix * x.ToMatrix()));
+  EXPECT_TRUE(matrix.MulVectorTransposed(y) ==
+              S21Vector(matrix.Transpose() * y.ToMatrix()));
+
+  S21Vector out = VectorTestData(300);
+  matrix.MulVector(x, out, 2.0, -1.0);
+  EXPECT_TRUE(out == S21Vector(matrix * x.ToMatrix() * 2.0 - y.ToMatrix()));
+  S21Vector out_t = VectorTestData(201);
+  matrix.MulVectorTransposed(y, out_t, 0.5, 3.0);
+  EXPECT_TRUE(out_t == S21Vector(matrix.Transpose() * y.ToMatrix() * 0.5 +
+                                 x.ToMatrix() * 3.0));
+  EXPECT_THROW(matrix.MulVector(y), std::out_of_range);
+  EXPECT_THROW(matrix.MulVectorTransposed(x), std::out_of_range);
+}
+
+TEST(gemv_suite, rank_updates) {
+  S21Matrix matrix = TiledTestMatrix(30, 20);
+  S21Vector x = VectorTestData(30), y = VectorTestData(20);
+  S21Matrix expected = matrix + x.ToMatrix() * y.ToMatrix().Transpose() * 2.0;
+  matrix.RankOneUpdate(2.0, x, y);
+  EXPECT_TRUE(matrix == expected);
+
+  S21Matrix gram = SymmetricTestMatrix(30);
+  S21Matrix expected_gram = matrix * matrix.Transpose() * 0.5 + gram * 2.0;
+  gram.RankKUpdate(0.5, matrix, 2.0);
+  EXPECT_TRUE(gram == expected_gram);
+  EXPECT_THROW(matrix.RankKUpdate(1.0, matrix), std::out_of_range);
+  EXPECT_THROW(gram.RankKUpdate(1.0, gram), std::invalid_argument);
+}
+
+TEST(pow_suite, basic) {
+  S21Matrix matrix = TiledTestMatrix(6, 6) * 0.1;
+  S21Matrix expected = Identity(6);
+  for (int k = 0; k <= 11; ++k) {
+    EXPECT_TRUE(matrix.Pow(k) == expected);
+    expected *= matrix;
+  }
+  S21Matrix inverse = matrix.InverseMatrix();
+  EXPECT_TRUE(matrix.Pow(-3) == inverse * inverse * inverse);
+  EXPECT_THROW(S21Matrix(2, 3).Pow(2), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(3, 3).Pow(-1), std::invalid_argument);
+}
+
+TEST(exp_suite, basic) {
+  S21Matrix nilpotent(3, 3);
+  nilpotent(0, 1) = 1.0;
+  nilpotent(1, 2) = 1.0;
+  S21Matrix expected = Identity(3) + nilpotent;
+  expected(0, 2) = 0.5;
+  EXPECT_TRUE(nilpotent.Exp() == expected);
+
+  // Angles across all Pade degrees and with scaling and squaring.
+  for (double angle : {0.001, 0.1, 0.5, 1.5, 3.0, 40.0}) {
+    S21Matrix rotation(2, 2);
+    rotation(0, 1) = -angle;
+    rotation(1, 0) = angle;
+    S21Matrix result = rotation.Exp();
+    EXPECT_NEAR(result(0, 0), cos(angle), 1e-12);
+    EXPECT_NEAR(result(0, 1), -sin(angle), 1e-12);
+    EXPECT_NEAR(result(1, 0), sin(angle), 1e-12);
+    EXPECT_NEAR(result(1, 1), cos(angle), 1e-12);
+  }
+
+  S21Matrix matrix = TiledTestMatrix(8, 8) * 0.05;
+  EXPECT_TRUE(matrix.Exp() * (matrix * -1.0).Exp() == Identity(8));
+  EXPECT_THROW(S21Matrix(2, 3).Exp(), std::invalid_argument);
+}
+
+TEST(thread_pool_suite, parallel_for_by_thread) {
+  S21ThreadPool pool(4);
+  pool.PinThreads(true);
+  std::vector<int> hits(1001, 0);
+  pool.ParallelForByThread(0, 1001, [&hits](int first, int last) {
+    for (int i = first; i < last; ++i) ++hits[i];
+  });
+  EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1001);
+  EXPECT_THROW(pool.ParallelForByThread(
+                   0, 10, [](int, int) { throw std::logic_error("body"); }),
+               std::logic_error);
+  pool.PinThreads(false);
+}
+
+TEST(numa_suite, policies) {
+  S21Matrix a = TiledTestMatrix(700, 400), b = TiledTestMatrix(700, 400);
+  b.MulNumber(0.5);
+  S21Vector x = VectorTestData(400);
+  S21Matrix sum = a + b, difference = a - b;
+  S21Vector product = a.MulVector(x);
+  for (S21NumaPolicy policy :
+       {S21NumaPolicy::kLocal, S21NumaPolicy::kInterleave}) {
+    S21SetNumaPolicy(policy);
+    EXPECT_EQ(S21GetNumaPolicy(), policy);
+    S21Matrix zero(700, 400);
+    EXPECT_EQ(std::count(&zero(0, 0), &zero(0, 0) + 700 * 400, 0.0),
+              700 * 400);
+    EXPECT_TRUE(a + b == sum);
+    EXPECT_TRUE(a - b == difference);
+    EXPECT_TRUE(a.MulVector(x) == product);
+    EXPECT_TRUE(a * 0.5 == b);
+  }
+  S21SetNumaPolicy(S21NumaPolicy::kDefault);
+}
+
+TEST(constructor, uninitialized) {
+  S21Matrix matrix(3, 4, S21Uninitialized());
+  EXPECT_EQ(matrix.GetRows(), 3);
+  EXPECT_EQ(matrix.GetCols(), 4);
+  matrix(2, 3) = 1.5;
+  EXPECT_EQ(matrix(2, 3), 1.5);
+  EXPECT_THROW(S21Matrix(0, 4, S21Uninitialized()), std::out_of_range);
+}
+
+TEST(constructor, large_allocation) {
+  S21Matrix large(600, 500);
+  EXPECT_EQ(std::count(&large(0, 0), &large(0, 0) + 600 * 500, 0.0),
+            600 * 500);
+  large(599, 499) = 2.0;
+  S21Matrix copy(large), small(2, 2);
+  EXPECT_TRUE(copy == large);
+  small = large;
+  EXPECT_TRUE(small == large);
+  copy = S21Matrix(2, 2);
+  EXPECT_EQ(copy.GetRows(), 2);
+  large = std::move(copy);
+  EXPECT_EQ(large.GetRows(), 2);
+  EXPECT_EQ(small.Transpose()(499, 599), 2.0);
+
+  // Large blocks sit on huge page boundaries and come back zero even
+  // right after a block of the same size was filled and freed.
+  for (int round = 0; round < 2; ++round) {
+    S21Matrix block(600, 500, S21Uninitialized());
+    EXPECT_EQ((uintptr_t)&block(0, 0) % (1 << 21), 0u);
+    EXPECT_EQ(std::count(&block(0, 0), &block(0, 0) + 600 * 500, 0.0),
+              600 * 500);
+    std::fill(&block(0, 0), &block(0, 0) + 600 * 500, 1.0);
+  }
+}
+
+TEST(copy_on_write_suite, detach_on_write) {
+  S21Matrix original = TiledTestMatrix(4, 4);
+  S21Matrix copy(original), assigned;
+  assigned = original;
+  copy(1, 2) = 100.0;
+  assigned.MulNumber(2.0);
+  EXPECT_TRUE(original == TiledTestMatrix(4, 4));
+  EXPECT_EQ(copy(1, 2), 100.0);
+  EXPECT_TRUE(assigned == TiledTestMatrix(4, 4) * 2.0);
+
+  S21Matrix shared(original);
+  original.SumMatrix(shared);
+  EXPECT_TRUE(original == TiledTestMatrix(4, 4) * 2.0);
+  EXPECT_TRUE(shared == TiledTestMatrix(4, 4));
+  S21Matrix gram(shared);
+  gram.RankKUpdate(1.0, shared, 0.0);
+  EXPECT_TRUE(gram == shared * shared.Transpose());
+}
+
+TEST(copy_on_write_suite, concurrent_readers) {
+  const S21Matrix parameters = TiledTestMatrix(40, 40);
+  const S21Matrix expected_product = parameters * parameters;
+  const double expected_determinant = parameters.Determinant();
+  std::vector<std::thread> readers;
+  std::atomic<int> mismatches(0);
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&]() {
+      S21Matrix local(parameters);
+      for (int k = 0; k < 5; ++k) {
+        S21Matrix product = local * parameters;
+        if (!(product == expected_product) ||
+            parameters.Determinant() != expected_determinant ||
+            !(parameters.Transpose().Transpose() == local)) {
+          ++mismatches;
+        }
+        local.MulNumber(1.0);
+      }
+    });
+  }
+  for (std::thread& reader : readers) reader.join();
+  EXPECT_EQ(mismatches, 0);
+}
+
+TEST(accumulation_suite, long_sums) {
+  const int size = 200000;
+  S21Matrix row(1, size), column(size, 1);
+  S21Vector ones(size), tenths(size);
+  for (int i = 0; i < size; ++i) {
+    row(0, i) = 0.1;
+    column(i, 0) = 1.0;
+    ones(i) = 1.0;
+    tenths(i) = 0.1;
+  }
+  S21Matrix tall(size, 1);
+  for (int i = 0; i < size; ++i) tall(i, 0) = 0.1;
+  double fast_error = 0.0;
+  for (S21Accumulation mode :
+       {S21Accumulation::kFast, S21Accumulation::kPairwise,
+        S21Accumulation::kCompensated}) {
+    S21SetAccumulation(mode);
+    EXPECT_EQ(S21GetAccumulation(), mode);
+    double errors[] = {
+        fabs((row * column)(0, 0) - 20000.0),
+        fabs(tenths.Dot(ones) - 20000.0),
+        fabs(S21Sum(&row(0, 0), size) - 20000.0),
+        fabs(tall.MulVectorTransposed(S21Vector(ones))(0) - 20000.0)};
+    for (double error : errors) {
+      if (mode == S21Accumulation::kFast) {
+        fast_error = std::max(fast_error, error);
+      } else {
+        EXPECT_LT(error, mode == S21Accumulation::kPairwise ? 1e-10 : 2e-11);
+      }
+    }
+  }
+  S21SetAccumulation(S21Accumulation::kFast);
+  EXPECT_GT(fast_error, 1e-9);
+
+  S21Matrix a = TiledTestMatrix(300, 200), b = TiledTestMatrix(200, 150);
+  S21Matrix expected = a * b;
+  S21SetAccumulation(S21Accumulation::kCompensated);
+  EXPECT_TRUE(a * b == expected);
+  S21SetAccumulation(S21Accumulation::kPairwise);
+  EXPECT_TRUE(a * b == expected);
+  S21SetAccumulation(S21Accumulation::kFast);
+}
+
+TEST(reduction_suite, against_loops) {
+  for (auto size : {std::make_pair(1, 1), std::make_pair(4, 7),
+                    std::make_pair(1000, 300), std::make_pair(3, 70000)}) {
+    int rows = size.first, cols = size.second;
+    S21Matrix matrix(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < cols; ++j) {
+        matrix(i, j) = ((i * 37 + j * 11) % 101) * 0.25 - 12.0 + i * 0.001;
+      }
+    }
+    matrix(rows / 2, cols / 3) = 100.0;
+    const S21Matrix& view = matrix;
+    double sum = 0.0, squares = 0.0, norm_inf = 0.0, norm_1 = 0.0;
+    double low = view(0, 0);
+    std::vector<double> row_sums(rows, 0.0), col_sums(cols, 0.0);
+    std::vector<double> col_abs(cols, 0.0);
+    for (int i = 0; i < rows; ++i) {
+      double row_abs = 0.0;
+      for (int j = 0; j < cols; ++j) {
+        double value = view(i, j);
+        sum += value;
+        squares += value * value;
+        row_sums[i] += value;
+        col_sums[j] += value;
+        row_abs += fabs(value);
+        col_abs[j] += fabs(value);
+        low = std::min(low, value);
+      }
+      norm_inf = std::max(norm_inf, row_abs);
+    }
+    for (double value : col_abs) norm_1 = std::max(norm_1, value);
+    double tolerance = 1e-9 * rows * cols;
+    EXPECT_NEAR(view.Sum(), sum, tolerance);
+    EXPECT_NEAR(view.NormFro(), sqrt(squares), tolerance);
+    EXPECT_NEAR(view.NormInf(), norm_inf, tolerance);
+    EXPECT_NEAR(view.Norm1(), norm_1, tolerance);
+    EXPECT_EQ(view.Min(), low);
+    EXPECT_EQ(view.Max(), 100.0);
+    EXPECT_EQ(view.ArgMax(), std::make_pair(rows / 2, cols / 3));
+
+    S21Vector row_result = view.RowSums(), col_result = view.ColSums();
+    S21Statistics by_row = view.Statistics(S21Axis::kRows);
+    S21Statistics by_col = view.Statistics(S21Axis::kCols);
+    EXPECT_TRUE(view.Mean(S21Axis::kRows) == by_row.mean);
+    EXPECT_TRUE(view.Variance(S21Axis::kCols) == by_col.variance);
+    for (int i = 0; i < rows; ++i) {
+      double mean = row_sums[i] / cols, variance = 0.0;
+      for (int j = 0; j < cols; ++j) {
+        variance += (view(i, j) - mean) * (view(i, j) - mean) / cols;
+      }
+      EXPECT_NEAR(row_result(i), row_sums[i], tolerance);
+      EXPECT_NEAR(by_row.mean(i), mean, 1e-9);
+      EXPECT_NEAR(by_row.variance(i), variance, 1e-9);
+    }
+    for (int j = 0; j < cols; ++j) {
+      double mean = col_sums[j] / rows, variance = 0.0;
+      for (int i = 0; i < rows; ++i) {
+        variance += (view(i, j) - mean) * (view(i, j) - mean) / rows;
+      }
+      EXPECT_NEAR(col_result(j), col_sums[j], tolerance);
+      EXPECT_NEAR(by_col.mean(j), mean, 1e-9);
+      EXPECT_NEAR(by_col.variance(j), variance, 1e-9);
+    }
+  }
+}
+
+TEST(reduction_suite, frobenius_scaling) {
+  S21Matrix huge(2, 2), tiny(2, 2);
+  huge(0, 0) = 3e200;
+  huge(1, 1) = -4e200;
+  tiny(0, 1) = 3e-200;
+  tiny(1, 0) = 4e-200;
+  EXPECT_NEAR(huge.NormFro() / 5e200, 1.0, 1e-15);
+  EXPECT_NEAR(tiny.NormFro() / 5e-200, 1.0, 1e-15);
+  EXPECT_EQ(S21Matrix(3, 3).NormFro(), 0.0);
+}
+
+S21Matrix NaiveConvolution(const S21Matrix& image, const S21Matrix& kernel,
+                           bool full) {
+  int kr = kernel.GetRows(), kc = kernel.GetCols();
+  int shift_r = full ? kr - 1 : 0, shift_c = full ? kc - 1 : 0;
+  int rows = full ? image.GetRows() + kr - 1 : image.GetRows() - kr + 1;
+  int cols = full ? image.GetCols() + kc - 1 : image.GetCols() - kc + 1;
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      for (int a = 0; a < kr; ++a) {
+        for (int b = 0; b < kc; ++b) {
+          int r = i + a - shift_r, c = j + b - shift_c;
+          if (r >= 0 && c >= 0 && r < image.GetRows() && c < image.GetCols()) {
+            result(i, j) += image(r, c) * kernel(kr - 1 - a, kc - 1 - b);
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+TEST(convolution_suite, methods_agree) {
+  S21Matrix image = TiledTestMatrix(37, 29), second = TiledTestMatrix(37, 29);
+  second.MulNumber(-0.5);
+  for (auto size : {std::make_pair(1, 1), std::make_pair(3, 5),
+                    std::make_pair(11, 9)}) {
+    S21Matrix kernel = TiledTestMatrix(size.first, size.second) * 0.1;
+    for (bool full : {false, true}) {
+      S21ConvolutionMode mode =
+          full ? S21ConvolutionMode::kFull : S21ConvolutionMode::kValid;
+      S21Matrix expected = NaiveConvolution(image, kernel, full);
+      for (S21ConvolutionMethod method :
+           {S21ConvolutionMethod::kAuto, S21ConvolutionMethod::kDirect,
+            S21ConvolutionMethod::kFft}) {
+        EXPECT_TRUE(S21Convolve2D(image, kernel, mode, method) == expected);
+        S21Matrix channels =
+            S21Convolve2D({image, second}, {kernel, kernel * 2.0}, mode,
+                          method);
+        EXPECT_TRUE(channels == expected + NaiveConvolution(
+                                               second, kernel * 2.0, full));
+      }
+    }
+  }
+}
+
+TEST(convolution_suite, exception) {
+  S21Matrix image(4, 4), kernel(5, 2);
+  EXPECT_THROW(S21Convolve2D(image, kernel), std::out_of_range);
+  EXPECT_NO_THROW(S21Convolve2D(image, kernel, S21ConvolutionMode::kFull));
+  EXPECT_THROW(S21Convolve2D({image, image}, {kernel}), std::invalid_argument);
+  EXPECT_THROW(S21Convolve2D({image, S21Matrix(3, 4)}, {kernel, kernel},
+                             S21ConvolutionMode::kFull),
+               std::out_of_range);
+}
+
+TEST(toeplitz_matrix_suite, kernels) {
+  for (int size : {5, 100}) {
+    S21Vector column = VectorTestData(size), row = VectorTestData(size);
+    row.MulNumber(0.5);
+    column(0) = row(0) = 3.0;
+    S21ToeplitzMatrix toeplitz(column, row);
+    S21Matrix dense = toeplitz.ToMatrix();
+    EXPECT_EQ(dense(size - 1, 0), column(size - 1));
+    EXPECT_EQ(toeplitz(0, size - 1), row(size - 1));
+    S21Vector x = VectorTestData(size);
+    EXPECT_TRUE(toeplitz.MulVector(x) == dense.MulVector(x));
+    S21Matrix other = TiledTestMatrix(size, 3);
+    EXPECT_TRUE(toeplitz.MulMatrix(other) == dense * other);
+    EXPECT_TRUE(toeplitz.Transpose().ToMatrix() == dense.Transpose());
+    EXPECT_TRUE(S21ToeplitzMatrix(dense).ToMatrix() == dense);
+
+    S21CirculantMatrix circulant(column);
+    S21Matrix cyclic = circulant.ToMatrix();
+    EXPECT_EQ(cyclic(0, 1), column(size - 1));
+    EXPECT_TRUE(circulant.MulVector(x) == cyclic.MulVector(x));
+    EXPECT_TRUE(circulant.MulMatrix(other) == cyclic * other);
+    EXPECT_TRUE(circulant.Transpose().ToMatrix() == cyclic.Transpose());
+    EXPECT_TRUE(S21CirculantMatrix(cyclic).ToMatrix() == cyclic);
+  }
+}
+
+TEST(toeplitz_matrix_suite, exception) {
+  S21Vector column(4), row(4), short_row(3);
+  row(0) = 1.0;
+  EXPECT_THROW(S21ToeplitzMatrix(column, row), std::invalid_argument);
+  EXPECT_THROW(S21ToeplitzMatrix(column, short_row), std::out_of_range);
+  EXPECT_THROW(S21ToeplitzMatrix(TiledTestMatrix(4, 4)),
+               std::invalid_argument);
+  EXPECT_THROW(S21CirculantMatrix(TiledTestMatrix(4, 4)),
+               std::invalid_argument);
+  S21CirculantMatrix circulant(column);
+  EXPECT_THROW(circulant(4, 0), std::out_of_range);
+  EXPECT_THROW(circulant.MulMatrix(S21Matrix(3, 1)), std::out_of_range);
+}
+
+TEST(matrix_server_suite, requests) {
+  EXPECT_THROW(S21MatrixClient("s21_matrix_missing.sock"), std::runtime_error);
+  S21MatrixServer server(TempPath("matrix.sock"));
+  std::thread runner(&S21MatrixServer::Run, &server);
+  {
+    S21MatrixClient client(TempPath("matrix.sock"));
+    S21Matrix a = TiledTestMatrix(5, 5), b = TiledTestMatrix(5, 3);
+    client.Put("a", a);
+    client.Put("b", b);
+    EXPECT_TRUE(client.Get("a") == a);
+    EXPECT_TRUE(client.Multiply("a", "b") == a * b);
+    EXPECT_TRUE(client.Solve("a", "b") == a.Solve(b));
+    EXPECT_TRUE(client.Inverse("a") == a.InverseMatrix());
+    EXPECT_DOUBLE_EQ(client.Determinant("a"), a.Determinant());
+
+    client.Send(S21ServerOp::kMultiply, {"a", "b", "c"});
+    S21ServerResponse stored = client.Receive();
+    EXPECT_TRUE(stored.ok);
+    EXPECT_EQ(stored.kind, S21ServerAnswer::kNone);
+    EXPECT_TRUE(client.Get("c") == a * b);
+    client.Drop("c");
+    EXPECT_THROW(client.Get("c"), std::runtime_error);
+    EXPECT_THROW(client.Multiply("b", "a"), std::runtime_error);
+    EXPECT_THROW(client.Send(S21ServerOp::kGet, {std::string(70000, 'x')}),
+                 std::invalid_argument);
+
+    std::string metrics = client.Metrics();
+    EXPECT_NE(metrics.find("multiply: count 3"), std::string::npos);
+    EXPECT_NE(metrics.find("determinant: count 1"), std::string::npos);
+  }
+  server.Stop();
+  runner.join();
+}
+
+// Connects without S21MatrixClient, so tests can send broken frames.
+int RawServerSocket(const char* path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path);
+  int raw = socket(AF_UNIX, SOCK_STREAM, 0);
+  connect(raw, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  return raw;
+}
+
+TEST(matrix_server_suite, malformed) {
+  S21MatrixServer server(TempPath("matrix.sock"));
+  std::thread runner(&S21MatrixServer::Run, &server);
+  {
+    int raw = RawServerSocket(TempPath("matrix.sock").c_str());
+    // Only the id and an unknown op: the name count is missing.
+    char frame[9] = {5, 0, 0, 0, 7, 0, 0, 0, (char)200};
+    ASSERT_EQ(send(raw, frame, sizeof(frame), 0), (ssize_t)sizeof(frame));
+    char answer[9];
+    ASSERT_EQ(recv(raw, answer, sizeof(answer), MSG_WAITALL),
+              (ssize_t)sizeof(answer));
+    EXPECT_EQ(answer[4], 7);
+    EXPECT_EQ(answer[8], 1);
+    close(raw);
+
+    // A frame above the limit closes the connection without an answer.
+    raw = RawServerSocket(TempPath("matrix.sock").c_str());
+    uint32_t huge = S21MatrixServer::kMaxFrameBytes + 1;
+    ASSERT_EQ(send(raw, &huge, sizeof(huge), 0), (ssize_t)sizeof(huge));
+    EXPECT_EQ(recv(raw, answer, sizeof(answer), MSG_WAITALL), 0);
+    close(raw);
+
+    S21MatrixClient client(TempPath("matrix.sock"));
+    EXPECT_EQ(client.Metrics(), "");
+  }
+  server.Stop();
+  runner.join();
+}
+
+TEST(matrix_server_suite, closed_connections) {
+  S21MatrixServer server(TempPath("matrix.sock"));
+  std::thread runner(&S21MatrixServer::Run, &server);
+  for (int i = 0; i < 20; ++i) {
+    S21MatrixClient client(TempPath("matrix.sock"));
+    client.Put("a", S21Matrix(2, 2));
+    EXPECT_GE(server.Connections(), 1);
+  }
+  // Readers close their connection once they see the end of the stream.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (server.Connections() > 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(server.Connections(), 0);
+  server.Stop();
+  runner.join();
+}
+
+TEST(matrix_server_suite, socket_path) {
+  std::string path = TempPath("matrix.sock");
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  std::fclose(file);
+  EXPECT_THROW(S21MatrixServer server(path), std::runtime_error);
+  EXPECT_TRUE(std::filesystem::is_regular_file(path));
+  std::remove(path.c_str());
+
+  // A socket nobody listens on is taken over, a live one is not.
+  int stale = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, path.c_str());
+  ASSERT_EQ(bind(stale, reinterpret_cast<sockaddr*>(&address),
+                 sizeof(address)),
+            0);
+  close(stale);
+  S21MatrixServer server(path);
+  EXPECT_THROW(S21MatrixServer other(path), std::runtime_error);
+}
+
+TEST(matrix_server_suite, pipelining) {
+  S21MatrixServer server(TempPath("matrix.sock"));
+  std::thread runner(&S21MatrixServer::Run, &server);
+  {
+    S21MatrixClient client(TempPath("matrix.sock"));
+    std::vector<S21Matrix> expected;
+    for (int i = 0; i < 8; ++i) {
+      S21Matrix matrix = TiledTestMatrix(6, 6) * (i + 1.0);
+      client.Put("m" + std::to_string(i), matrix);
+      expected.push_back(matrix * matrix);
+    }
+    std::vector<uint32_t> ids;
+    // More rounds than kMaxPendingRequests, so the reader has to wait.
+    for (int round = 0; round < 12; ++round) {
+      for (int i = 0; i < 8; ++i) {
+        std::string name = "m" + std::to_string(i);
+        ids.push_back(client.Send(S21ServerOp::kMultiply, {name, name}));
+      }
+    }
+    client.Send(S21ServerOp::kDeterminant, {"missing"});
+    int errors = 0;
+    for (size_t i = 0; i <= ids.size(); ++i) {
+      S21ServerResponse response = client.Receive();
+      if (!response.ok) {
+        ++errors;
+        continue;
+      }
+      auto found = std::find(ids.begin(), ids.end(), response.id);
+      ASSERT_TRUE(found != ids.end());
+      EXPECT_TRUE(response.matrix == expected[(found - ids.begin()) % 8]);
+      EXPECT_GT(response.latency_ns, 0u);
+    }
+    EXPECT_EQ(errors, 1);
+  }
+  server.Stop();
+  runner.join();
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
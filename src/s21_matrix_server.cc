@@ -0,0 +1,607 @@
+#include "s21_matrix_server.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Builds a frame: the size field is filled in by Finish().
+class FrameWriter {
+ public:
+  FrameWriter() : data_(4) {}
+  template <typename T>
+  void Put(T value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(T));
+  }
+  void PutName(const std::string& name) {
+    if (name.size() > UINT16_MAX) {
+      throw std::invalid_argument("Incorrect input, matrix name is too long");
+    }
+    Put<uint16_t>(name.size());
+    data_.insert(data_.end(), name.begin(), name.end());
+  }
+  // Text runs to the end of the frame, so it has no length of its own.
+  void PutText(const std::string& text) {
+    data_.insert(data_.end(), text.begin(), text.end());
+  }
+  static uint64_t MatrixSize(const S21Matrix& matrix) {
+    return 2 * sizeof(int32_t) +
+           sizeof(double) * (uint64_t)matrix.GetRows() * matrix.GetCols();
+  }
+  void PutMatrix(const S21Matrix& matrix) {
+    Put<int32_t>(matrix.GetRows());
+    Put<int32_t>(matrix.GetCols());
+    const char* bytes = reinterpret_cast<const char*>(&matrix(0, 0));
+    data_.insert(data_.end(), bytes,
+                 bytes + sizeof(double) * matrix.GetRows() * matrix.GetCols());
+  }
+  // Whether `more` bytes can still be added without passing the limit.
+  bool Fits(uint64_t more) const {
+    return data_.size() - 4 + more <= S21MatrixServer::kMaxFrameBytes;
+  }
+  std::vector<char>& Finish() {
+    if (!Fits(0)) {
+      throw std::invalid_argument("Incorrect input, message is too large");
+    }
+    uint32_t size = data_.size() - 4;
+    std::memcpy(data_.data(), &size, 4);
+    return data_;
+  }
+
+ private:
+  std::vector<char> data_;
+};
+
+// Reads the fields of a frame body, throwing on anything that does not fit.
+class FrameReader {
+ public:
+  explicit FrameReader(const std::vector<char>& data) : data_(data), at_(0) {}
+  template <typename T>
+  T Get() {
+    Need(sizeof(T));
+    T value;
+    std::memcpy(&value, data_.data() + at_, sizeof(T));
+    at_ += sizeof(T);
+    return value;
+  }
+  std::string GetName() {
+    size_t size = Get<uint16_t>();
+    Need(size);
+    std::string name(data_.data() + at_, size);
+    at_ += size;
+    return name;
+  }
+  S21Matrix GetMatrix() {
+    int32_t rows = Get<int32_t>(), cols = Get<int32_t>();
+    if (rows < 1 || cols < 1) throw std::runtime_error("Malformed message");
+    size_t bytes = sizeof(double) * (uint64_t)rows * (uint64_t)cols;
+    Need(bytes);
+    S21Matrix matrix(rows, cols, S21Uninitialized());
+    std::memcpy(&matrix(0, 0), data_.data() + at_, bytes);
+    at_ += bytes;
+    return matrix;
+  }
+  std::string GetRest() {
+    std::string rest(data_.data() + at_, data_.size() - at_);
+    at_ = data_.size();
+    return rest;
+  }
+
+ private:
+  const std::vector<char>& data_;
+  size_t at_;
+  void Need(size_t size) const {
+    if (data_.size() - at_ < size) {
+      throw std::runtime_error("Malformed message");
+    }
+  }
+};
+
+static bool ReadAll(int socket, void* data, size_t size) {
+  char* at = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t done = recv(socket, at, size, 0);
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) return false;
+    at += done;
+    size -= done;
+  }
+  return true;
+}
+
+// Writing to a socket whose peer has gone must fail instead of raising
+// SIGPIPE. Linux takes a send flag; systems without it, such as macOS, take
+// a socket option.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static void IgnorePeerClose(int socket) {
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#else
+  (void)socket;
+#endif
+}
+
+static bool WriteAll(int socket, const void* data, size_t size) {
+  const char* at = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t done = send(socket, at, size, MSG_NOSIGNAL);
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) return false;
+    at += done;
+    size -= done;
+  }
+  return true;
+}
+
+// Reads one frame body, the size prefix already stripped, and fails on a
+// frame above `limit`. The buffer grows with the data actually received, so
+// a size that is announced but never sent costs no memory.
+static bool ReadFrame(int socket, std::vector<char>& body, uint32_t limit) {
+  const size_t step = 1 << 20;
+  uint32_t size;
+  if (!ReadAll(socket, &size, sizeof(size)) || size > limit) return false;
+  body.clear();
+  while (body.size() < size) {
+    size_t at = body.size();
+    body.resize(std::min<size_t>(size, at + step));
+    if (!ReadAll(socket, body.data() + at, body.size() - at)) return false;
+  }
+  return true;
+}
+
+static sockaddr_un SocketAddress(const std::string& path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument("Incorrect input, socket path is too long");
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return address;
+}
+
+static uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static const char* OpName(int op) {
+  static const char* names[] = {"",         "put",   "get",
+                                "drop",     "multiply", "solve",
+                                "inverse",  "determinant", "metrics"};
+  return names[op];
+}
+
+struct S21MatrixServer::Connection {
+  explicit Connection(int socket) : socket(socket) {}
+  ~Connection() { close(socket); }
+  int socket;
+  std::mutex write_mutex;
+  // Requests read from this connection and not answered yet.
+  std::mutex pending_mutex;
+  std::condition_variable pending_done;
+  int pending = 0;
+};
+
+S21MatrixServer::S21MatrixServer(const std::string& socket_path,
+                                 S21ThreadPool& pool)
+    : path_(socket_path),
+      pool_(pool),
+      stopping_(false),
+      readers_(0),
+      pending_(0) {
+  sockaddr_un address = SocketAddress(path_);
+  listener_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener_ < 0) {
+    throw std::runtime_error("Cannot create the socket " + path_);
+  }
+  struct stat info;
+  if (lstat(path_.c_str(), &info) == 0) {
+    // Only a socket left behind by a server that is gone refuses a connect.
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool stale = S_ISSOCK(info.st_mode) && probe >= 0 &&
+                 connect(probe, reinterpret_cast<sockaddr*>(&address),
+                         sizeof(address)) != 0 &&
+                 errno == ECONNREFUSED;
+    if (probe >= 0) close(probe);
+    if (!stale) {
+      close(listener_);
+      throw std::runtime_error("The path " + path_ + " is in use");
+    }
+    unlink(path_.c_str());
+  }
+  if (bind(listener_, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listener_, SOMAXCONN) != 0 || pipe(wake_) != 0) {
+    close(listener_);
+    throw std::runtime_error("Cannot listen on the socket " + path_);
+  }
+}
+
+S21MatrixServer::~S21MatrixServer() {
+  close(listener_);
+  close(wake_[0]);
+  close(wake_[1]);
+  unlink(path_.c_str());
+}
+
+void S21MatrixServer::Run() {
+  while (!stopping_) {
+    pollfd events[2] = {{listener_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+    if (poll(events, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    if (events[1].revents != 0) break;
+    if ((events[0].revents & POLLIN) == 0) continue;
+    int client = accept(listener_, nullptr, nullptr);
+    if (client < 0) continue;
+    IgnorePeerClose(client);
+    auto connection = std::make_shared<Connection>(client);
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    connections_.push_back(connection);
+    ++readers_;
+    std::thread(&S21MatrixServer::Read, this, connection).detach();
+  }
+  std::unique_lock<std::mutex> lock(connections_mutex_);
+  for (const auto& connection : connections_) {
+    shutdown(connection->socket, SHUT_RD);
+  }
+  readers_done_.wait(lock, [this] { return readers_ == 0; });
+  lock.unlock();
+  std::unique_lock<std::mutex> pending_lock(pending_mutex_);
+  pending_done_.wait(pending_lock, [this] { return pending_ == 0; });
+}
+
+void S21MatrixServer::Stop() {
+  stopping_ = true;
+  char signal = 0;
+  if (write(wake_[1], &signal, 1) < 0) return;
+}
+
+// A frame that is too large or cannot be allocated ends the connection
+// like the end of input does: once the requests already read are answered,
+// the socket is shut down so the client sees the end of the stream.
+void S21MatrixServer::Read(std::shared_ptr<Connection> connection) {
+  try {
+    std::vector<char> request;
+    while (ReadFrame(connection->socket, request, kMaxFrameBytes)) {
+      uint64_t received_ns = NowNs();
+      {
+        std::unique_lock<std::mutex> lock(connection->pending_mutex);
+        connection->pending_done.wait(lock, [&connection] {
+          return connection->pending < kMaxPendingRequests;
+        });
+        ++connection->pending;
+      }
+      {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        ++pending_;
+      }
+      try {
+        auto body = std::make_shared<std::vector<char>>(std::move(request));
+        pool_.Submit([this, connection, body, received_ns]() {
+          try {
+            Handle(connection, std::move(*body), received_ns);
+          } catch (const std::exception&) {
+            // No memory even for the response: the client would wait for
+            // it forever, so hang up instead.
+            shutdown(connection->socket, SHUT_RDWR);
+          }
+          Finish(*connection);
+        });
+      } catch (...) {
+        Finish(*connection);
+        throw;
+      }
+    }
+  } catch (const std::exception&) {
+  }
+  {
+    std::unique_lock<std::mutex> lock(connection->pending_mutex);
+    connection->pending_done.wait(
+        lock, [&connection] { return connection->pending == 0; });
+  }
+  shutdown(connection->socket, SHUT_RDWR);
+  // The socket closes with the last reference, and this thread touches
+  // nothing of the server once Run() can see readers_ drop to zero.
+  std::lock_guard<std::mutex> lock(connections_mutex_);
+  connections_.erase(
+      std::find(connections_.begin(), connections_.end(), connection));
+  if (--readers_ == 0) readers_done_.notify_all();
+}
+
+void S21MatrixServer::Finish(Connection& connection) {
+  {
+    std::lock_guard<std::mutex> lock(connection.pending_mutex);
+    --connection.pending;
+  }
+  connection.pending_done.notify_one();
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  if (--pending_ == 0) pending_done_.notify_all();
+}
+
+S21Matrix S21MatrixServer::Find(const std::string& name) {
+  std::shared_lock<std::shared_mutex> lock(store_mutex_);
+  auto found = store_.find(name);
+  if (found == store_.end()) {
+    throw std::invalid_argument("No matrix named " + name);
+  }
+  return found->second;
+}
+
+// Runs one request and writes its response. Errors of any kind, including
+// malformed requests, become an error response with the same id.
+void S21MatrixServer::Handle(const std::shared_ptr<Connection>& connection,
+                             std::vector<char> request,
+                             uint64_t received_ns) {
+  FrameReader reader(request);
+  uint32_t id = 0;
+  int op = 0;
+  bool ok = true;
+  S21ServerAnswer kind = S21ServerAnswer::kNone;
+  S21Matrix matrix;
+  double value = 0.0;
+  std::string text;
+  try {
+    id = reader.Get<uint32_t>();
+    op = reader.Get<uint8_t>();
+    if (op >= (int)metrics_.size()) op = 0;
+    std::vector<std::string> names(reader.Get<uint8_t>());
+    for (std::string& name : names) name = reader.GetName();
+    bool has_matrix = reader.Get<uint8_t>() != 0;
+    if (has_matrix) matrix = reader.GetMatrix();
+
+    auto expect = [&names, has_matrix](size_t least, size_t most,
+                                       bool matrix_needed) {
+      if (names.size() < least || names.size() > most ||
+          has_matrix != matrix_needed) {
+        throw std::invalid_argument("Incorrect request");
+      }
+    };
+    size_t out = 0;
+    switch (static_cast<S21ServerOp>(op)) {
+      case S21ServerOp::kPut: {
+        expect(1, 1, true);
+        std::unique_lock<std::shared_mutex> lock(store_mutex_);
+        store_[names[0]] = std::move(matrix);
+        break;
+      }
+      case S21ServerOp::kGet:
+        expect(1, 1, false);
+        matrix = Find(names[0]);
+        kind = S21ServerAnswer::kMatrix;
+        break;
+      case S21ServerOp::kDrop: {
+        expect(1, 1, false);
+        std::unique_lock<std::shared_mutex> lock(store_mutex_);
+        if (store_.erase(names[0]) == 0) {
+          throw std::invalid_argument("No matrix named " + names[0]);
+        }
+        break;
+      }
+      case S21ServerOp::kMultiply:
+        expect(2, 3, false);
+        matrix = Find(names[0]) * Find(names[1]);
+        kind = S21ServerAnswer::kMatrix;
+        out = 2;
+        break;
+      case S21ServerOp::kSolve:
+        expect(2, 3, false);
+        matrix = Find(names[0]).Solve(Find(names[1]));
+        kind = S21ServerAnswer::kMatrix;
+        out = 2;
+        break;
+      case S21ServerOp::kInverse:
+        expect(1, 2, false);
+        matrix = Find(names[0]).InverseMatrix();
+        kind = S21ServerAnswer::kMatrix;
+        out = 1;
+        break;
+      case S21ServerOp::kDeterminant:
+        expect(1, 1, false);
+        value = Find(names[0]).Determinant();
+        kind = S21ServerAnswer::kValue;
+        break;
+      case S21ServerOp::kMetrics:
+        expect(0, 0, false);
+        text = Metrics();
+        kind = S21ServerAnswer::kText;
+        break;
+      default:
+        throw std::invalid_argument("Unknown operation");
+    }
+    if (out != 0 && names.size() > out) {
+      std::unique_lock<std::shared_mutex> lock(store_mutex_);
+      store_[names[out]] = std::move(matrix);
+      kind = S21ServerAnswer::kNone;
+    }
+  } catch (const std::exception& error) {
+    ok = false;
+    kind = S21ServerAnswer::kText;
+    text = error.what();
+  }
+
+  uint64_t latency_ns = NowNs() - received_ns;
+  if (op != 0) {
+    OpMetrics& metrics = metrics_[op];
+    ++metrics.count;
+    metrics.total_ns += latency_ns;
+    uint64_t max_ns = metrics.max_ns;
+    while (latency_ns > max_ns &&
+           !metrics.max_ns.compare_exchange_weak(max_ns, latency_ns)) {
+    }
+    ++metrics.buckets[63 - __builtin_clzll(latency_ns | 1)];
+  }
+
+  FrameWriter writer;
+  auto header = [&]() {
+    writer = FrameWriter();
+    writer.Put<uint32_t>(id);
+    writer.Put<uint8_t>(ok ? 0 : 1);
+    writer.Put<uint64_t>(latency_ns);
+    writer.Put<uint8_t>(static_cast<uint8_t>(kind));
+  };
+  header();
+  if (kind == S21ServerAnswer::kMatrix &&
+      !writer.Fits(FrameWriter::MatrixSize(matrix))) {
+    ok = false;
+    kind = S21ServerAnswer::kText;
+    text = "Result is too large";
+    header();
+  }
+  if (kind == S21ServerAnswer::kMatrix) {
+    writer.PutMatrix(matrix);
+  } else if (kind == S21ServerAnswer::kValue) {
+    writer.Put<double>(value);
+  } else if (kind == S21ServerAnswer::kText) {
+    writer.PutText(text);
+  }
+  std::vector<char>& frame = writer.Finish();
+  std::lock_guard<std::mutex> lock(connection->write_mutex);
+  WriteAll(connection->socket, frame.data(), frame.size());
+}
+
+int S21MatrixServer::Connections() const {
+  std::lock_guard<std::mutex> lock(connections_mutex_);
+  return connections_.size();
+}
+
+// Percentiles are upper bounds of the power-of-two histogram buckets.
+std::string S21MatrixServer::Metrics() const {
+  std::ostringstream report;
+  for (size_t op = 1; op < metrics_.size(); ++op) {
+    const OpMetrics& metrics = metrics_[op];
+    uint64_t count = metrics.count;
+    if (count == 0) continue;
+    auto percentile = [&metrics, count](double share) {
+      uint64_t seen = 0;
+      for (size_t bucket = 0; bucket < metrics.buckets.size(); ++bucket) {
+        seen += metrics.buckets[bucket];
+        if (seen >= share * count) return (double)(2ull << bucket) / 1000.0;
+      }
+      return (double)metrics.max_ns / 1000.0;
+    };
+    report << OpName(op) << ": count " << count << ", mean "
+           << (double)metrics.total_ns / count / 1000.0 << " us, p50 <= "
+           << percentile(0.5) << " us, p99 <= " << percentile(0.99)
+           << " us, max " << (double)metrics.max_ns / 1000.0 << " us\n";
+  }
+  return report.str();
+}
+
+S21MatrixClient::S21MatrixClient(const std::string& socket_path)
+    : next_id_(1) {
+  sockaddr_un address = SocketAddress(socket_path);
+  socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket_ < 0 || connect(socket_, reinterpret_cast<sockaddr*>(&address),
+                             sizeof(address)) != 0) {
+    if (socket_ >= 0) close(socket_);
+    throw std::runtime_error("Cannot connect to the socket " + socket_path);
+  }
+  IgnorePeerClose(socket_);
+}
+
+S21MatrixClient::~S21MatrixClient() { close(socket_); }
+
+uint32_t S21MatrixClient::Send(S21ServerOp op,
+                               const std::vector<std::string>& names,
+                               const S21Matrix* matrix) {
+  if (names.size() > UINT8_MAX) {
+    throw std::invalid_argument("Incorrect input, too many names");
+  }
+  uint32_t id = next_id_++;
+  FrameWriter writer;
+  writer.Put<uint32_t>(id);
+  writer.Put<uint8_t>(static_cast<uint8_t>(op));
+  writer.Put<uint8_t>(names.size());
+  for (const std::string& name : names) writer.PutName(name);
+  writer.Put<uint8_t>(matrix != nullptr);
+  if (matrix != nullptr) writer.PutMatrix(*matrix);
+  std::vector<char>& frame = writer.Finish();
+  if (!WriteAll(socket_, frame.data(), frame.size())) {
+    throw std::runtime_error("Cannot send the request");
+  }
+  return id;
+}
+
+S21ServerResponse S21MatrixClient::Receive() {
+  std::vector<char> body;
+  if (!ReadFrame(socket_, body, S21MatrixServer::kMaxFrameBytes)) {
+    throw std::runtime_error("Connection to the server is closed");
+  }
+  FrameReader reader(body);
+  S21ServerResponse response{};
+  response.id = reader.Get<uint32_t>();
+  response.ok = reader.Get<uint8_t>() == 0;
+  response.latency_ns = reader.Get<uint64_t>();
+  response.kind = static_cast<S21ServerAnswer>(reader.Get<uint8_t>());
+  if (response.kind == S21ServerAnswer::kMatrix) {
+    response.matrix = reader.GetMatrix();
+  } else if (response.kind == S21ServerAnswer::kValue) {
+    response.value = reader.Get<double>();
+  } else if (response.kind == S21ServerAnswer::kText) {
+    response.text = reader.GetRest();
+  }
+  return response;
+}
+
+S21ServerResponse S21MatrixClient::Call(S21ServerOp op,
+                                        const std::vector<std::string>& names,
+                                        const S21Matrix* matrix) {
+  uint32_t id = Send(op, names, matrix);
+  S21ServerResponse response = Receive();
+  if (response.id != id) {
+    throw std::runtime_error("Response does not match the request");
+  }
+  if (!response.ok) throw std::runtime_error(response.text);
+  return response;
+}
+
+void S21MatrixClient::Put(const std::string& name, const S21Matrix& matrix) {
+  Call(S21ServerOp::kPut, {name}, &matrix);
+}
+
+S21Matrix S21MatrixClient::Get(const std::string& name) {
+  return Call(S21ServerOp::kGet, {name}).matrix;
+}
+
+void S21MatrixClient::Drop(const std::string& name) {
+  Call(S21ServerOp::kDrop, {name});
+}
+
+S21Matrix S21MatrixClient::Multiply(const std::string& a,
+                                    const std::string& b) {
+  return Call(S21ServerOp::kMultiply, {a, b}).matrix;
+}
+
+S21Matrix S21MatrixClient::Solve(const std::string& a, const std::string& b) {
+  return Call(S21ServerOp::kSolve, {a, b}).matrix;
+}
+
+S21Matrix S21MatrixClient::Inverse(const std::string& a) {
+  return Call(S21ServerOp::kInverse, {a}).matrix;
+}
+
+double S21MatrixClient::Determinant(const std::string& a) {
+  return Call(S21ServerOp::kDeterminant, {a}).value;
+}
+
+std::string S21MatrixClient::Metrics() {
+  return Call(S21ServerOp::kMetrics, {}).text;
+}
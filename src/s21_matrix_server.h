@@ -0,0 +1,162 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_SERVER_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_SERVER_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+// Binary protocol over a local Unix socket. Integers and doubles are in host
+// byte order, since both ends run on one machine.
+//
+//   request  = u32 size | u32 id | u8 op | u8 name count | names
+//              | u8 has matrix | [matrix]
+//   response = u32 size | u32 id | u8 status | u64 latency ns | u8 kind
+//              | body
+//
+// `size` counts the bytes after itself. A name is u16 length and bytes, a
+// matrix is i32 rows, i32 cols and the elements row by row. Responses come
+// in completion order, so clients may pipeline any number of requests and
+// match the answers by id. Latency runs from the moment the request was
+// read until its response was ready, queueing included.
+//
+//   op            names           matrix  answer
+//   kPut          name            yes     -
+//   kGet          name            no      matrix
+//   kDrop         name            no      -
+//   kMultiply     a, b [, out]    no      a * b
+//   kSolve        a, b [, out]    no      x with a * x = b
+//   kInverse      a [, out]       no      a^-1
+//   kDeterminant  a               no      value
+//   kMetrics      -               no      text
+//
+// A matrix answer is stored under `out` instead of being sent back when
+// that name is given. No frame may exceed S21MatrixServer::kMaxFrameBytes:
+// the server closes a connection that sends a larger request and answers
+// with an error when a result would not fit. It also stops reading from a
+// connection that has kMaxPendingRequests requests unanswered until one of
+// them is done.
+enum class S21ServerOp : uint8_t {
+  kPut = 1,
+  kGet,
+  kDrop,
+  kMultiply,
+  kSolve,
+  kInverse,
+  kDeterminant,
+  kMetrics
+};
+
+enum class S21ServerAnswer : uint8_t { kNone, kMatrix, kValue, kText };
+
+struct S21ServerResponse {
+  uint32_t id;
+  bool ok;
+  uint64_t latency_ns;
+  S21ServerAnswer kind;
+  S21Matrix matrix;
+  double value;
+  // The metrics report, or the error message when !ok.
+  std::string text;
+};
+
+// Keeps named matrices resident for every client of the socket and runs
+// their requests on one shared pool. Each connection has a reader thread
+// that hands every request to the pool as soon as it is read.
+class S21MatrixServer {
+ public:
+  static constexpr uint32_t kMaxFrameBytes = 1u << 30;
+  static constexpr int kMaxPendingRequests = 64;
+
+  // Takes over `socket_path` only when it is a socket nobody listens on
+  // anymore; throws std::runtime_error when it is another kind of file or
+  // a live server owns it.
+  explicit S21MatrixServer(const std::string& socket_path,
+                           S21ThreadPool& pool = S21ThreadPool::Default());
+  S21MatrixServer(const S21MatrixServer& other) = delete;
+  ~S21MatrixServer();
+
+  S21MatrixServer& operator=(const S21MatrixServer& other) = delete;
+
+  // Accepts connections until Stop() is called from another thread, then
+  // waits for the requests already read to finish.
+  void Run();
+  void Stop();
+  // Per-operation request counts and latencies as text.
+  std::string Metrics() const;
+  // Connections accepted and not closed yet. A connection is closed once
+  // its client has gone away and its requests have been answered.
+  int Connections() const;
+
+ private:
+  struct Connection;
+  // Latency histogram with power-of-two nanosecond buckets.
+  struct OpMetrics {
+    std::atomic<uint64_t> count{0}, total_ns{0}, max_ns{0};
+    std::array<std::atomic<uint64_t>, 64> buckets{};
+  };
+  std::string path_;
+  S21ThreadPool& pool_;
+  int listener_, wake_[2];
+  std::atomic<bool> stopping_;
+  std::shared_mutex store_mutex_;
+  std::unordered_map<std::string, S21Matrix> store_;
+  // Open connections and the detached reader threads serving them; a
+  // reader removes its connection when the client goes away.
+  mutable std::mutex connections_mutex_;
+  std::vector<std::shared_ptr<Connection>> connections_;
+  int readers_;
+  std::condition_variable readers_done_;
+  std::mutex pending_mutex_;
+  std::condition_variable pending_done_;
+  int pending_;
+  std::array<OpMetrics, 9> metrics_;
+
+  void Read(std::shared_ptr<Connection> connection);
+  void Finish(Connection& connection);
+  void Handle(const std::shared_ptr<Connection>& connection,
+              std::vector<char> request, uint64_t received_ns);
+  S21Matrix Find(const std::string& name);
+};
+
+// Client side of the protocol. The Send/Receive pair pipelines requests;
+// the other members send one request, wait for its answer and throw
+// std::runtime_error with the server message on failure.
+class S21MatrixClient {
+ public:
+  explicit S21MatrixClient(const std::string& socket_path);
+  S21MatrixClient(const S21MatrixClient& other) = delete;
+  ~S21MatrixClient();
+
+  S21MatrixClient& operator=(const S21MatrixClient& other) = delete;
+
+  uint32_t Send(S21ServerOp op, const std::vector<std::string>& names,
+                const S21Matrix* matrix = nullptr);
+  S21ServerResponse Receive();
+
+  void Put(const std::string& name, const S21Matrix& matrix);
+  S21Matrix Get(const std::string& name);
+  void Drop(const std::string& name);
+  S21Matrix Multiply(const std::string& a, const std::string& b);
+  S21Matrix Solve(const std::string& a, const std::string& b);
+  S21Matrix Inverse(const std::string& a);
+  double Determinant(const std::string& a);
+  std::string Metrics();
+
+ private:
+  int socket_;
+  uint32_t next_id_;
+  S21ServerResponse Call(S21ServerOp op, const std::vector<std::string>& names,
+                         const S21Matrix* matrix = nullptr);
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_MATRIX_SERVER_H_
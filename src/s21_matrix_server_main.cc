@@ -0,0 +1,37 @@
+#include <signal.h>
+
+#include <iostream>
+#include <thread>
+
+#include "s21_matrix_server.h"
+
+// Usage: s21_matrix_server [socket path]
+//
+// Requests run on the library-wide pool, so the parallel kernels inside
+// them share its workers instead of oversubscribing the machine.
+int main(int argc, char** argv) {
+  std::string path = argc > 1 ? argv[1] : "/tmp/s21_matrix.sock";
+
+  // Block the signals before any thread starts, so only the waiter sees them.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  try {
+    S21MatrixServer server(path);
+    std::thread waiter([&server, &signals] {
+      int signal = 0;
+      sigwait(&signals, &signal);
+      server.Stop();
+    });
+    waiter.detach();
+    server.Run();
+    std::cerr << server.Metrics();
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include "s21_numa.h"
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+static std::atomic<S21NumaPolicy> numa_policy(S21NumaPolicy::kDefault);
+
+void S21SetNumaPolicy(S21NumaPolicy policy) {
+  numa_policy = policy;
+  S21ThreadPool::Default().PinThreads(policy != S21NumaPolicy::kDefault);
+}
+
+S21NumaPolicy S21GetNumaPolicy() { return numa_policy; }
+
+#ifdef __linux__
+// Online nodes from the sysfs list, e.g. "0-1" or "0,2-3"; empty when the
+// file is missing.
+static std::vector<int> OnlineNodes() {
+  std::vector<int> nodes;
+  std::ifstream file("/sys/devices/system/node/online");
+  std::string list;
+  if (!(file >> list)) return nodes;
+  int first = -1, value = 0;
+  for (char symbol : list + ",") {
+    if (symbol >= '0' && symbol <= '9') {
+      value = value * 10 + (symbol - '0');
+    } else if (symbol == '-') {
+      first = value;
+      value = 0;
+    } else {
+      for (int node = first < 0 ? value : first; node <= value; ++node) {
+        nodes.push_back(node);
+      }
+      first = -1;
+      value = 0;
+    }
+  }
+  return nodes;
+}
+
+void S21NumaInterleave(void *data, size_t bytes) {
+  static const std::vector<int> nodes = OnlineNodes();
+  if (nodes.size() < 2) return;
+  uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t first = ((uintptr_t)data + page - 1) / page * page;
+  uintptr_t last = ((uintptr_t)data + bytes) / page * page;
+  if (first >= last) return;
+  const size_t bits = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> mask(nodes.back() / bits + 1, 0);
+  for (int node : nodes) mask[node / bits] |= 1ul << (node % bits);
+  syscall(SYS_mbind, first, last - first, MPOL_INTERLEAVE, mask.data(),
+          mask.size() * bits + 1, MPOL_MF_MOVE);
+}
+#else
+void S21NumaInterleave(void *, size_t) {}
+#endif
@@ -0,0 +1,31 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_NUMA_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_NUMA_H_
+
+#include <cstddef>
+
+// Placement of large matrix buffers on multi-socket hosts.
+//  kDefault    - nothing is placed on purpose: pages of large buffers
+//                land on the node of the thread that first writes them,
+//                and the pool threads may run on any CPU.
+//  kLocal      - the default pool is pinned and first-touches each buffer
+//                with the same row blocks that the streaming kernels later
+//                use, so every worker reads memory of its own node.
+//                Large buffers are fresh mappings, so no page is placed
+//                before that touch.
+//  kInterleave - pages are spread round robin over all nodes, for buffers
+//                whose access pattern does not follow the row blocks.
+// Both non-default policies pin the default pool threads to CPUs. Pinning
+// and interleaving need Linux; on other systems they do nothing, and
+// kLocal only keeps the first touch in the row blocks of the pool.
+enum class S21NumaPolicy { kDefault, kLocal, kInterleave };
+
+void S21SetNumaPolicy(S21NumaPolicy policy);
+S21NumaPolicy S21GetNumaPolicy();
+
+// Asks the kernel to interleave the whole pages inside [data, data + bytes)
+// over all online nodes. Pages that already exist are moved too, as far as
+// the kernel can. It is only a hint: on single-node hosts or kernels
+// without NUMA support nothing changes.
+void S21NumaInterleave(void* data, size_t bytes);
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_NUMA_H_
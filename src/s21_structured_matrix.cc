@@ -0,0 +1,739 @@
+#include "s21_structured_matrix.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_fft.h"
+#include "s21_kernels.h"
+
+// Below this size Toeplitz and circulant products are plain O(n^2) loops.
+const int kFftMinSize = 32;
+
+// Row starts of a dense operand, fetched once so that the structured
+// kernels run S21Axpy over whole rows instead of checked element access.
+static std::vector<double *> Rows(S21Matrix &matrix) {
+  std::vector<double *> rows(matrix.GetRows());
+  for (int i = 0; i < matrix.GetRows(); ++i) rows[i] = &matrix(i, 0);
+  return rows;
+}
+
+static std::vector<const double *> Rows(const S21Matrix &matrix) {
+  std::vector<const double *> rows(matrix.GetRows());
+  for (int i = 0; i < matrix.GetRows(); ++i) rows[i] = &matrix(i, 0);
+  return rows;
+}
+
+// Spectrum of `values` zero-padded to `length`.
+static std::vector<std::complex<double>> Spectrum(
+    const std::vector<double> &values, size_t length) {
+  std::vector<std::complex<double>> result(length);
+  std::copy(values.begin(), values.end(), result.begin());
+  S21Fft(result, false);
+  return result;
+}
+
+// Linear convolutions of `spectrum` with every column of `other`, each
+// column zero-padded to the spectrum length and left as one row of the
+// result.
+static std::vector<std::complex<double>> ConvolveColumns(
+    const std::vector<std::complex<double>> &spectrum,
+    const S21Matrix &other) {
+  size_t length = spectrum.size(), cols = other.GetCols();
+  std::vector<std::complex<double>> result(cols * length);
+  for (int i = 0; i < other.GetRows(); ++i) {
+    for (size_t j = 0; j < cols; ++j) result[j * length + i] = other(i, j);
+  }
+  S21FftRows(result.data(), cols, length, false);
+  for (size_t j = 0; j < cols; ++j) {
+    for (size_t k = 0; k < length; ++k) result[j * length + k] *= spectrum[k];
+  }
+  S21FftRows(result.data(), cols, length, true);
+  return result;
+}
+
+S21SymmetricMatrix::S21SymmetricMatrix(int size) {
+  if (size < 1) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have cols and rows");
+  }
+  size_ = size;
+  data_.assign((size_t)size_ * (size_ + 1) / 2, 0.0);
+}
+
+S21SymmetricMatrix::S21SymmetricMatrix(const S21Matrix &other)
+    : S21SymmetricMatrix(other.GetRows()) {
+  if (other.GetRows() != other.GetCols()) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  for (int i = 0; i < size_; ++i) {
+    for (int j = i; j < size_; ++j) {
+      if (fabs(other(i, j) - other(j, i)) > eps) {
+        throw std::invalid_argument("The matrix is not symmetric");
+      }
+      data_[Index(i, j)] = other(i, j);
+    }
+  }
+}
+
+size_t S21SymmetricMatrix::Index(int row, int col) const {
+  if (row > col) std::swap(row, col);
+  return (size_t)row * size_ - (size_t)row * (row - 1) / 2 + (col - row);
+}
+
+double &S21SymmetricMatrix::operator()(int row, int col) {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return data_[Index(row, col)];
+}
+
+double S21SymmetricMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return data_[Index(row, col)];
+}
+
+S21Matrix S21SymmetricMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = i; j < size_; ++j) {
+      result(i, j) = result(j, i) = data_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+// Every packed element is read once and contributes to both of its mirrored
+// positions.
+S21Matrix S21SymmetricMatrix::MulMatrix(const S21Matrix &other) const {
+  if (size_ != other.GetRows()) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  int cols = other.GetCols();
+  S21Matrix result(size_, cols);
+  std::vector<double *> out = Rows(result);
+  std::vector<const double *> in = Rows(other);
+  for (int i = 0; i < size_; ++i) {
+    const double *row = &data_[Index(i, i)];
+    for (int j = i; j < size_; ++j) {
+      double value = row[j - i];
+      S21Axpy(value, in[j], out[i], cols);
+      if (j != i) S21Axpy(value, in[i], out[j], cols);
+    }
+  }
+  return result;
+}
+
+S21SymmetricMatrix S21SymmetricMatrix::Transpose() const { return *this; }
+
+// A = U^T * D * U with unit upper U, right-looking so that every update walks
+// contiguous packed rows. Fails on a negligible pivot; callers fall back to
+// the pivoted dense path then.
+bool S21SymmetricMatrix::DecomposeLDLT(std::vector<double> &ldlt) const {
+  ldlt = data_;
+  double max_abs = 0.0;
+  for (double value : data_) max_abs = fmax(max_abs, fabs(value));
+  double tolerance = size_ * DBL_EPSILON * max_abs;
+
+  for (int k = 0; k < size_; ++k) {
+    double *row_k = &ldlt[Index(k, k)];
+    double pivot = row_k[0];
+    if (pivot <= tolerance) {
+      return false;
+    }
+    for (int i = k + 1; i < size_; ++i) {
+      double factor = row_k[i - k] / pivot;
+      double *row_i = &ldlt[Index(i, i)];
+      for (int j = i; j < size_; ++j) {
+        row_i[j - i] -= factor * row_k[j - k];
+      }
+    }
+    for (int j = k + 1; j < size_; ++j) {
+      row_k[j - k] /= pivot;
+    }
+  }
+  return true;
+}
+
+double S21SymmetricMatrix::Determinant() const {
+  std::vector<double> ldlt;
+  if (!DecomposeLDLT(ldlt)) {
+    return ToMatrix().Determinant();
+  }
+  double result = 1.0;
+  for (int k = 0; k < size_; ++k) {
+    result *= ldlt[Index(k, k)];
+  }
+  return result;
+}
+
+S21Matrix S21SymmetricMatrix::Solve(const S21Matrix &rhs) const {
+  if (size_ != rhs.GetRows()) {
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as the "
+        "matrix");
+  }
+  std::vector<double> ldlt;
+  if (!DecomposeLDLT(ldlt)) {
+    return ToMatrix().Solve(rhs);
+  }
+  int cols = rhs.GetCols();
+  S21Matrix result(rhs);
+  std::vector<double *> out = Rows(result);
+  for (int k = 0; k < size_; ++k) {
+    const double *row_k = &ldlt[Index(k, k)];
+    for (int i = k + 1; i < size_; ++i) {
+      S21Axpy(-row_k[i - k], out[k], out[i], cols);
+    }
+  }
+  for (int k = 0; k < size_; ++k) {
+    double pivot = ldlt[Index(k, k)];
+    for (int c = 0; c < cols; ++c) out[k][c] /= pivot;
+  }
+  for (int i = size_ - 1; i >= 0; --i) {
+    const double *row_i = &ldlt[Index(i, i)];
+    for (int j = i + 1; j < size_; ++j) {
+      S21Axpy(-row_i[j - i], out[j], out[i], cols);
+    }
+  }
+  return result;
+}
+
+S21TriangularMatrix::S21TriangularMatrix(int size, bool upper) {
+  if (size < 1) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have cols and rows");
+  }
+  size_ = size;
+  upper_ = upper;
+  data_.assign((size_t)size_ * (size_ + 1) / 2, 0.0);
+}
+
+S21TriangularMatrix::S21TriangularMatrix(const S21Matrix &other, bool upper)
+    : S21TriangularMatrix(other.GetRows(), upper) {
+  if (other.GetRows() != other.GetCols()) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      if (InStructure(i, j)) {
+        data_[Index(i, j)] = other(i, j);
+      } else if (fabs(other(i, j)) > eps) {
+        throw std::invalid_argument("The matrix is not triangular");
+      }
+    }
+  }
+}
+
+bool S21TriangularMatrix::InStructure(int row, int col) const {
+  return upper_ ? row <= col : row >= col;
+}
+
+size_t S21TriangularMatrix::Index(int row, int col) const {
+  if (upper_) {
+    return (size_t)row * size_ - (size_t)row * (row - 1) / 2 + (col - row);
+  }
+  return (size_t)row * (row + 1) / 2 + col;
+}
+
+double &S21TriangularMatrix::operator()(int row, int col) {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  if (!InStructure(row, col)) {
+    throw std::out_of_range(
+        "Incorrect input, element is outside the matrix structure");
+  }
+  return data_[Index(row, col)];
+}
+
+double S21TriangularMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return InStructure(row, col) ? data_[Index(row, col)] : 0.0;
+}
+
+S21Matrix S21TriangularMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    int first = upper_ ? i : 0, last = upper_ ? size_ - 1 : i;
+    for (int j = first; j <= last; ++j) {
+      result(i, j) = data_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::MulMatrix(const S21Matrix &other) const {
+  if (size_ != other.GetRows()) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  int cols = other.GetCols();
+  S21Matrix result(size_, cols);
+  std::vector<double *> out = Rows(result);
+  std::vector<const double *> in = Rows(other);
+  for (int i = 0; i < size_; ++i) {
+    int first = upper_ ? i : 0, last = upper_ ? size_ - 1 : i;
+    for (int j = first; j <= last; ++j) {
+      S21Axpy(data_[Index(i, j)], in[j], out[i], cols);
+    }
+  }
+  return result;
+}
+
+S21TriangularMatrix S21TriangularMatrix::Transpose() const {
+  S21TriangularMatrix result(size_, !upper_);
+  for (int i = 0; i < size_; ++i) {
+    int first = upper_ ? i : 0, last = upper_ ? size_ - 1 : i;
+    for (int j = first; j <= last; ++j) {
+      result.data_[result.Index(j, i)] = data_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+double S21TriangularMatrix::Determinant() const {
+  double result = 1.0;
+  for (int k = 0; k < size_; ++k) {
+    result *= data_[Index(k, k)];
+  }
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::Solve(const S21Matrix &rhs) const {
+  if (size_ != rhs.GetRows()) {
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as the "
+        "matrix");
+  }
+  // The determinant itself under- or overflows for large sizes, so each
+  // pivot is compared with the largest one instead.
+  double max_diagonal = 0.0;
+  for (int i = 0; i < size_; ++i) {
+    max_diagonal = fmax(max_diagonal, fabs(data_[Index(i, i)]));
+  }
+  for (int i = 0; i < size_; ++i) {
+    if (fabs(data_[Index(i, i)]) <= size_ * DBL_EPSILON * max_diagonal) {
+      throw std::invalid_argument("Matrix determinant is 0");
+    }
+  }
+  int cols = rhs.GetCols();
+  S21Matrix result(rhs);
+  std::vector<double *> out = Rows(result);
+  for (int step = 0; step < size_; ++step) {
+    int i = upper_ ? size_ - 1 - step : step;
+    int first = upper_ ? i + 1 : 0, last = upper_ ? size_ - 1 : i - 1;
+    for (int j = first; j <= last; ++j) {
+      S21Axpy(-data_[Index(i, j)], out[j], out[i], cols);
+    }
+    double diagonal = data_[Index(i, i)];
+    for (int c = 0; c < cols; ++c) out[i][c] /= diagonal;
+  }
+  return result;
+}
+
+S21BandMatrix::S21BandMatrix(int size, int lower, int upper) {
+  if (size < 1) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have cols and rows");
+  }
+  if (lower < 0 || upper < 0 || lower >= size || upper >= size) {
+    throw std::out_of_range("Incorrect input, bandwidth is out of range");
+  }
+  size_ = size;
+  lower_ = lower;
+  upper_ = upper;
+  data_.assign((size_t)size_ * (lower_ + upper_ + 1), 0.0);
+}
+
+S21BandMatrix::S21BandMatrix(const S21Matrix &other, int lower, int upper)
+    : S21BandMatrix(other.GetRows(), lower, upper) {
+  if (other.GetRows() != other.GetCols()) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      if (InStructure(i, j)) {
+        data_[Index(i, j)] = other(i, j);
+      } else if (fabs(other(i, j)) > eps) {
+        throw std::invalid_argument("The matrix is outside the given band");
+      }
+    }
+  }
+}
+
+bool S21BandMatrix::InStructure(int row, int col) const {
+  return col - row <= upper_ && row - col <= lower_;
+}
+
+size_t S21BandMatrix::Index(int row, int col) const {
+  return (size_t)row * (lower_ + upper_ + 1) + (col - row + lower_);
+}
+
+double &S21BandMatrix::operator()(int row, int col) {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  if (!InStructure(row, col)) {
+    throw std::out_of_range(
+        "Incorrect input, element is outside the matrix structure");
+  }
+  return data_[Index(row, col)];
+}
+
+double S21BandMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return InStructure(row, col) ? data_[Index(row, col)] : 0.0;
+}
+
+S21Matrix S21BandMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    int first = std::max(0, i - lower_);
+    int last = std::min(size_ - 1, i + upper_);
+    for (int j = first; j <= last; ++j) {
+      result(i, j) = data_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21BandMatrix::MulMatrix(const S21Matrix &other) const {
+  if (size_ != other.GetRows()) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  int cols = other.GetCols();
+  S21Matrix result(size_, cols);
+  std::vector<double *> out = Rows(result);
+  std::vector<const double *> in = Rows(other);
+  for (int i = 0; i < size_; ++i) {
+    int first = std::max(0, i - lower_);
+    int last = std::min(size_ - 1, i + upper_);
+    for (int j = first; j <= last; ++j) {
+      S21Axpy(data_[Index(i, j)], in[j], out[i], cols);
+    }
+  }
+  return result;
+}
+
+S21BandMatrix S21BandMatrix::Transpose() const {
+  S21BandMatrix result(size_, upper_, lower_);
+  for (int i = 0; i < size_; ++i) {
+    int first = std::max(0, i - lower_);
+    int last = std::min(size_ - 1, i + upper_);
+    for (int j = first; j <= last; ++j) {
+      result.data_[result.Index(j, i)] = data_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+// Banded LU with partial pivoting. Row interchanges widen U to lower + upper
+// super-diagonals, so each row of `lu` keeps 2 * lower + upper + 1 slots.
+// Multipliers are kept apart and applied in pivot order, as LAPACK does.
+// Returns the permutation sign, or 0 for a singular matrix.
+int S21BandMatrix::DecomposeLU(std::vector<double> &lu,
+                               std::vector<double> &multipliers,
+                               std::vector<int> &pivots) const {
+  int width = 2 * lower_ + upper_ + 1, band = lower_ + upper_ + 1;
+  lu.assign((size_t)size_ * width, 0.0);
+  multipliers.assign((size_t)size_ * lower_, 0.0);
+  pivots.assign(size_, 0);
+  double max_abs = 0.0;
+  for (int i = 0; i < size_; ++i) {
+    for (int s = 0; s < band; ++s) {
+      lu[(size_t)i * width + s] = data_[(size_t)i * band + s];
+      max_abs = fmax(max_abs, fabs(data_[(size_t)i * band + s]));
+    }
+  }
+  double tolerance = size_ * DBL_EPSILON * max_abs;
+  auto at = [&](int row, int col) -> double & {
+    return lu[(size_t)row * width + (col - row + lower_)];
+  };
+
+  int sign = 1;
+  for (int k = 0; k < size_; ++k) {
+    int last_row = std::min(size_ - 1, k + lower_);
+    int last_col = std::min(size_ - 1, k + lower_ + upper_);
+    int pivot_row = k;
+    for (int i = k + 1; i <= last_row; ++i) {
+      if (fabs(at(i, k)) > fabs(at(pivot_row, k))) pivot_row = i;
+    }
+    pivots[k] = pivot_row;
+    if (fabs(at(pivot_row, k)) <= tolerance) {
+      return 0;
+    }
+    if (pivot_row != k) {
+      for (int j = k; j <= last_col; ++j) {
+        std::swap(at(k, j), at(pivot_row, j));
+      }
+      sign = -sign;
+    }
+    for (int i = k + 1; i <= last_row; ++i) {
+      double factor = at(i, k) / at(k, k);
+      multipliers[(size_t)k * lower_ + (i - k - 1)] = factor;
+      for (int j = k + 1; j <= last_col; ++j) {
+        at(i, j) -= factor * at(k, j);
+      }
+    }
+  }
+  return sign;
+}
+
+double S21BandMatrix::Determinant() const {
+  std::vector<double> lu, multipliers;
+  std::vector<int> pivots;
+  int sign = DecomposeLU(lu, multipliers, pivots);
+  double result = sign;
+  int width = 2 * lower_ + upper_ + 1;
+  for (int k = 0; k < size_ && sign != 0; ++k) {
+    result *= lu[(size_t)k * width + lower_];
+  }
+  return result;
+}
+
+S21Matrix S21BandMatrix::Solve(const S21Matrix &rhs) const {
+  if (size_ != rhs.GetRows()) {
+    throw std::out_of_range(
+        "Incorrect input, right-hand side should have as many rows as the "
+        "matrix");
+  }
+  std::vector<double> lu, multipliers;
+  std::vector<int> pivots;
+  if (DecomposeLU(lu, multipliers, pivots) == 0) {
+    throw std::invalid_argument("Matrix determinant is 0");
+  }
+  int width = 2 * lower_ + upper_ + 1, cols = rhs.GetCols();
+  S21Matrix result(rhs);
+  std::vector<double *> out = Rows(result);
+  for (int k = 0; k < size_; ++k) {
+    if (pivots[k] != k) {
+      std::swap_ranges(out[k], out[k] + cols, out[pivots[k]]);
+    }
+    int last_row = std::min(size_ - 1, k + lower_);
+    for (int i = k + 1; i <= last_row; ++i) {
+      double factor = multipliers[(size_t)k * lower_ + (i - k - 1)];
+      S21Axpy(-factor, out[k], out[i], cols);
+    }
+  }
+  for (int i = size_ - 1; i >= 0; --i) {
+    const double *row = &lu[(size_t)i * width + lower_];
+    int last_col = std::min(size_ - 1, i + lower_ + upper_);
+    for (int j = i + 1; j <= last_col; ++j) {
+      S21Axpy(-row[j - i], out[j], out[i], cols);
+    }
+    for (int c = 0; c < cols; ++c) out[i][c] /= row[0];
+  }
+  return result;
+}
+
+S21ToeplitzMatrix::S21ToeplitzMatrix(const S21Vector &first_col,
+                                     const S21Vector &first_row)
+    : size_(first_col.GetSize()) {
+  if (first_row.GetSize() != size_) {
+    throw std::out_of_range(
+        "Incorrect input, first column and row should have the same size");
+  }
+  if (fabs(first_col(0) - first_row(0)) > eps) {
+    throw std::invalid_argument(
+        "First column and row should start with the same element");
+  }
+  diagonals_.resize(2 * (size_t)size_ - 1);
+  for (int k = 0; k < size_; ++k) {
+    diagonals_[size_ - 1 - k] = first_row(k);
+    diagonals_[size_ - 1 + k] = first_col(k);
+  }
+  Prepare();
+}
+
+S21ToeplitzMatrix::S21ToeplitzMatrix(const S21Matrix &other)
+    : size_(other.GetRows()) {
+  if (other.GetRows() != other.GetCols()) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  diagonals_.resize(2 * (size_t)size_ - 1);
+  for (int k = 0; k < size_; ++k) {
+    diagonals_[size_ - 1 - k] = other(0, k);
+    diagonals_[size_ - 1 + k] = other(k, 0);
+  }
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      if (fabs(other(i, j) - diagonals_[i - j + size_ - 1]) > eps) {
+        throw std::invalid_argument("The matrix is not Toeplitz");
+      }
+    }
+  }
+  Prepare();
+}
+
+// Products are convolutions with the diagonals, whose spectrum is kept for
+// sizes where the FFT pays off. A length of 2n - 1 is enough: the wrap of
+// the cyclic convolution only reaches outputs that are not used.
+void S21ToeplitzMatrix::Prepare() {
+  spectrum_.clear();
+  if (size_ >= kFftMinSize) {
+    spectrum_ = Spectrum(diagonals_, S21FftSize(2 * (size_t)size_ - 1));
+  }
+}
+
+double S21ToeplitzMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return diagonals_[row - col + size_ - 1];
+}
+
+S21Matrix S21ToeplitzMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      result(i, j) = diagonals_[i - j + size_ - 1];
+    }
+  }
+  return result;
+}
+
+S21Vector S21ToeplitzMatrix::MulVector(const S21Vector &x) const {
+  return S21Vector(MulMatrix(x.ToMatrix()));
+}
+
+// Row i of the product is entry i + n - 1 of the convolution of the
+// diagonals with each column.
+S21Matrix S21ToeplitzMatrix::MulMatrix(const S21Matrix &other) const {
+  if (other.GetRows() != size_) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  int cols = other.GetCols();
+  S21Matrix result(size_, cols);
+  if (spectrum_.empty()) {
+    for (int i = 0; i < size_; ++i) {
+      for (int k = 0; k < size_; ++k) {
+        double value = diagonals_[i - k + size_ - 1];
+        for (int j = 0; j < cols; ++j) result(i, j) += value * other(k, j);
+      }
+    }
+    return result;
+  }
+  std::vector<std::complex<double>> products =
+      ConvolveColumns(spectrum_, other);
+  size_t length = spectrum_.size();
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      result(i, j) = products[j * length + i + size_ - 1].real();
+    }
+  }
+  return result;
+}
+
+S21ToeplitzMatrix S21ToeplitzMatrix::Transpose() const {
+  S21ToeplitzMatrix result(*this);
+  std::reverse(result.diagonals_.begin(), result.diagonals_.end());
+  result.Prepare();
+  return result;
+}
+
+S21CirculantMatrix::S21CirculantMatrix(const S21Vector &first_col)
+    : size_(first_col.GetSize()),
+      column_(first_col.Data(), first_col.Data() + first_col.GetSize()) {
+  Prepare();
+}
+
+S21CirculantMatrix::S21CirculantMatrix(const S21Matrix &other)
+    : size_(other.GetRows()) {
+  if (other.GetRows() != other.GetCols()) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  column_.resize(size_);
+  for (int k = 0; k < size_; ++k) column_[k] = other(k, 0);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      if (fabs(other(i, j) - column_[(i - j + size_) % size_]) > eps) {
+        throw std::invalid_argument("The matrix is not circulant");
+      }
+    }
+  }
+  Prepare();
+}
+
+// The cyclic convolution of length n is the linear one folded at n, and a
+// transform of at least 2n - 1 holds the linear one without wrapping.
+void S21CirculantMatrix::Prepare() {
+  spectrum_.clear();
+  if (size_ >= kFftMinSize) {
+    spectrum_ = Spectrum(column_, S21FftSize(2 * (size_t)size_ - 1));
+  }
+}
+
+double S21CirculantMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return column_[(row - col + size_) % size_];
+}
+
+S21Matrix S21CirculantMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      result(i, j) = column_[(i - j + size_) % size_];
+    }
+  }
+  return result;
+}
+
+S21Vector S21CirculantMatrix::MulVector(const S21Vector &x) const {
+  return S21Vector(MulMatrix(x.ToMatrix()));
+}
+
+S21Matrix S21CirculantMatrix::MulMatrix(const S21Matrix &other) const {
+  if (other.GetRows() != size_) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  int cols = other.GetCols();
+  S21Matrix result(size_, cols);
+  if (spectrum_.empty()) {
+    for (int i = 0; i < size_; ++i) {
+      for (int k = 0; k < size_; ++k) {
+        double value = column_[(i - k + size_) % size_];
+        for (int j = 0; j < cols; ++j) result(i, j) += value * other(k, j);
+      }
+    }
+    return result;
+  }
+  std::vector<std::complex<double>> products =
+      ConvolveColumns(spectrum_, other);
+  size_t length = spectrum_.size();
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      const std::complex<double> *row = products.data() + j * length;
+      result(i, j) = row[i].real() + row[i + size_].real();
+    }
+  }
+  return result;
+}
+
+S21CirculantMatrix S21CirculantMatrix::Transpose() const {
+  S21CirculantMatrix result(*this);
+  for (int k = 1; k < size_; ++k) {
+    result.column_[k] = column_[size_ - k];
+  }
+  result.Prepare();
+  return result;
+}
@@ -0,0 +1,148 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_STRUCTURED_MATRIX_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_STRUCTURED_MATRIX_H_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_vector.h"
+
+// Square matrices that store only the elements their structure allows.
+// Elements outside the structure read as 0 and cannot be written. Products
+// and solves take and return dense S21Matrix operands.
+
+// Symmetric matrix, upper triangle packed by rows: n * (n + 1) / 2 doubles.
+class S21SymmetricMatrix {
+ public:
+  explicit S21SymmetricMatrix(int size);
+  explicit S21SymmetricMatrix(const S21Matrix& other);
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  int GetSize() const { return size_; };
+  S21Matrix ToMatrix() const;
+
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  S21SymmetricMatrix Transpose() const;
+  double Determinant() const;
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  int size_;
+  std::vector<double> data_;
+  size_t Index(int row, int col) const;
+  // Unpivoted A = L * D * L^T, which is only stable without pivoting when
+  // A is positive definite. Fails on the first pivot that is not clearly
+  // positive, and callers then fall back to the dense LU with pivoting.
+  bool DecomposeLDLT(std::vector<double>& ldlt) const;
+};
+
+// Upper or lower triangular matrix packed by rows: n * (n + 1) / 2 doubles.
+class S21TriangularMatrix {
+ public:
+  S21TriangularMatrix(int size, bool upper);
+  S21TriangularMatrix(const S21Matrix& other, bool upper);
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  int GetSize() const { return size_; };
+  bool IsUpper() const { return upper_; };
+  S21Matrix ToMatrix() const;
+
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  S21TriangularMatrix Transpose() const;
+  double Determinant() const;
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  int size_;
+  bool upper_;
+  std::vector<double> data_;
+  bool InStructure(int row, int col) const;
+  size_t Index(int row, int col) const;
+};
+
+// Banded matrix with `lower` sub- and `upper` super-diagonals, stored by rows:
+// n * (lower + upper + 1) doubles.
+class S21BandMatrix {
+ public:
+  S21BandMatrix(int size, int lower, int upper);
+  S21BandMatrix(const S21Matrix& other, int lower, int upper);
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  int GetSize() const { return size_; };
+  int GetLower() const { return lower_; };
+  int GetUpper() const { return upper_; };
+  S21Matrix ToMatrix() const;
+
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  S21BandMatrix Transpose() const;
+  double Determinant() const;
+  S21Matrix Solve(const S21Matrix& rhs) const;
+
+ private:
+  int size_, lower_, upper_;
+  std::vector<double> data_;
+  bool InStructure(int row, int col) const;
+  size_t Index(int row, int col) const;
+  int DecomposeLU(std::vector<double>& lu, std::vector<double>& multipliers,
+                  std::vector<int>& pivots) const;
+};
+
+// Toeplitz matrix, constant along every diagonal, given by its first column
+// and first row: 2n - 1 doubles. Setting one element would change a whole
+// diagonal, so elements are read-only. Products are convolutions and take
+// O(n log n) through the FFT.
+class S21ToeplitzMatrix {
+ public:
+  S21ToeplitzMatrix(const S21Vector& first_col, const S21Vector& first_row);
+  explicit S21ToeplitzMatrix(const S21Matrix& other);
+
+  double operator()(int row, int col) const;
+
+  int GetSize() const { return size_; };
+  S21Matrix ToMatrix() const;
+
+  S21Vector MulVector(const S21Vector& x) const;
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  S21ToeplitzMatrix Transpose() const;
+
+ private:
+  int size_;
+  // Diagonals from the top-right corner down to the bottom-left one:
+  // element (i, j) is diagonals_[i - j + size_ - 1].
+  std::vector<double> diagonals_;
+  std::vector<std::complex<double>> spectrum_;
+  void Prepare();
+};
+
+// Circulant matrix, every column the previous one rotated down by one,
+// given by its first column: n doubles. Read-only like S21ToeplitzMatrix,
+// with O(n log n) products as cyclic convolutions.
+class S21CirculantMatrix {
+ public:
+  explicit S21CirculantMatrix(const S21Vector& first_col);
+  explicit S21CirculantMatrix(const S21Matrix& other);
+
+  double operator()(int row, int col) const;
+
+  int GetSize() const { return size_; };
+  S21Matrix ToMatrix() const;
+
+  S21Vector MulVector(const S21Vector& x) const;
+  S21Matrix MulMatrix(const S21Matrix& other) const;
+  S21CirculantMatrix Transpose() const;
+
+ private:
+  int size_;
+  std::vector<double> column_;
+  std::vector<std::complex<double>> spectrum_;
+  void Prepare();
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_STRUCTURED_MATRIX_H_
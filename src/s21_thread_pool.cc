@@ -0,0 +1,184 @@
+#include "s21_thread_pool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+// Pool and index of the worker running on this thread, if any.
+static thread_local const S21ThreadPool *current_pool = nullptr;
+static thread_local int current_index = -1;
+
+S21ThreadPool::S21ThreadPool(int threads) : stop_(false) {
+  if (threads < 1) {
+    throw std::out_of_range("Incorrect input, pool needs at least one thread");
+  }
+  for (int i = 0; i < threads; ++i) {
+    workers_.emplace_back(&S21ThreadPool::Work, this, i);
+  }
+}
+
+S21ThreadPool::~S21ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+void S21ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+void S21ThreadPool::ParallelFor(int begin, int end, int grain,
+                                const std::function<void(int, int)> &body) {
+  int count = end - begin;
+  if (count <= 0) return;
+  int chunks = std::min(GetThreads() * 4, (count + grain - 1) / grain);
+  if (chunks <= 1 || GetThreads() == 1) {
+    body(begin, end);
+    return;
+  }
+  struct Progress {
+    std::atomic<int> next{0};
+    std::atomic<int> left{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+  };
+  auto progress = std::make_shared<Progress>();
+  progress->left = chunks;
+  int size = (count + chunks - 1) / chunks;
+  // Helpers that start after the last chunk was claimed return without
+  // touching `body`, which may be gone by then.
+  auto work = [progress, begin, end, size, chunks, &body]() {
+    for (int chunk = progress->next++; chunk < chunks;
+         chunk = progress->next++) {
+      int first = begin + chunk * size, last = std::min(end, first + size);
+      try {
+        if (first < last) body(first, last);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        progress->error = std::current_exception();
+      }
+      if (--progress->left == 0) {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        progress->finished.notify_all();
+      }
+    }
+  };
+  for (int i = 1; i < std::min(chunks, GetThreads()); ++i) {
+    Submit(work);
+  }
+  work();
+  std::unique_lock<std::mutex> lock(progress->mutex);
+  progress->finished.wait(lock, [&progress] { return progress->left == 0; });
+  if (progress->error) std::rethrow_exception(progress->error);
+}
+
+void S21ThreadPool::ParallelForByThread(
+    int begin, int end, const std::function<void(int, int)> &body) {
+  int count = end - begin, blocks = GetThreads();
+  if (count <= 0) return;
+  if (blocks == 1) {
+    body(begin, end);
+    return;
+  }
+  struct Progress {
+    std::vector<std::atomic<bool>> claimed;
+    std::atomic<int> left;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+    explicit Progress(int blocks) : claimed(blocks), left(blocks) {}
+  };
+  auto progress = std::make_shared<Progress>(blocks);
+  // Block t is [begin + t * count / blocks, begin + (t + 1) * count / blocks),
+  // tried first by worker t and then by anyone who runs out of own work.
+  auto work = [this, progress, begin, count, blocks, &body]() {
+    int own = current_pool == this ? current_index : 0;
+    for (int step = 0; step < blocks; ++step) {
+      int block = (own + step) % blocks;
+      if (progress->claimed[block].exchange(true)) continue;
+      int first = begin + (int)((long long)block * count / blocks);
+      int last = begin + (int)((long long)(block + 1) * count / blocks);
+      try {
+        if (first < last) body(first, last);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        progress->error = std::current_exception();
+      }
+      if (--progress->left == 0) {
+        std::lock_guard<std::mutex> lock(progress->mutex);
+        progress->finished.notify_all();
+      }
+    }
+  };
+  for (int i = 0; i < blocks; ++i) {
+    Submit(work);
+  }
+  if (current_pool == this) work();
+  std::unique_lock<std::mutex> lock(progress->mutex);
+  progress->finished.wait(lock, [&progress] { return progress->left == 0; });
+  if (progress->error) std::rethrow_exception(progress->error);
+}
+
+void S21ThreadPool::PinThreads(bool pin) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+  }
+  if (cpus.empty()) return;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    cpu_set_t mask = allowed;
+    if (pin) {
+      CPU_ZERO(&mask);
+      CPU_SET(cpus[i % cpus.size()], &mask);
+    }
+    pthread_setaffinity_np(workers_[i].native_handle(), sizeof(mask), &mask);
+  }
+#else
+  (void)pin;
+#endif
+}
+
+S21ThreadPool &S21ThreadPool::Default() {
+  static S21ThreadPool pool(
+      std::thread::hardware_concurrency() ? std::thread::hardware_concurrency()
+                                          : 1);
+  return pool;
+}
+
+void S21ThreadPool::Work(int index) {
+  current_pool = this;
+  current_index = index;
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
@@ -0,0 +1,52 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_THREAD_POOL_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running submitted tasks in FIFO order. The
+// destructor finishes queued tasks before joining the workers.
+class S21ThreadPool {
+ public:
+  explicit S21ThreadPool(int threads);
+  S21ThreadPool(const S21ThreadPool& other) = delete;
+  ~S21ThreadPool();
+
+  S21ThreadPool& operator=(const S21ThreadPool& other) = delete;
+
+  void Submit(std::function<void()> task);
+  // Runs body(first, last) over chunks of [begin, end) of at least `grain`
+  // indices. The caller works on chunks too and returns when all are done,
+  // so it is safe to call from a task of the same pool.
+  void ParallelFor(int begin, int end, int grain,
+                   const std::function<void(int, int)>& body);
+  // Splits [begin, end) into one contiguous block per worker, and worker t
+  // takes block t whenever it is free to. Repeated calls over the same range
+  // thus touch the same rows from the same thread, which keeps first-touch
+  // placed pages local once the workers are pinned. A pool worker calling
+  // this works on blocks too; other callers only wait.
+  void ParallelForByThread(int begin, int end,
+                           const std::function<void(int, int)>& body);
+  // Binds worker t to the t-th CPU allowed for the calling thread (round
+  // robin), or gives every worker that whole set back. Only Linux exposes
+  // thread affinity; elsewhere this does nothing.
+  void PinThreads(bool pin);
+  int GetThreads() const { return (int)workers_.size(); };
+
+  // Library-wide pool with one worker per hardware thread.
+  static S21ThreadPool& Default();
+
+ private:
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stop_;
+  void Work(int index);
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_THREAD_POOL_H_
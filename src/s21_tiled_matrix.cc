@@ -0,0 +1,384 @@
+#include "s21_tiled_matrix.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+S21TiledMatrix::S21TiledMatrix(const std::string &path, int rows, int cols,
+                               int tile_size, int cache_tiles) {
+  if (rows < 1 || cols < 1) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have cols and rows");
+  }
+  if (tile_size < 1 || cache_tiles < 3) {
+    throw std::invalid_argument(
+        "Incorrect input, tiles should be non-empty and at least 3 of them "
+        "should fit in the cache");
+  }
+  rows_ = rows;
+  cols_ = cols;
+  tile_size_ = tile_size;
+  cache_tiles_ = cache_tiles;
+  tile_rows_ = (rows_ + tile_size_ - 1) / tile_size_;
+  tile_cols_ = (cols_ + tile_size_ - 1) / tile_size_;
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("Cannot open the matrix file " + path);
+  }
+  off_t bytes = (off_t)tile_rows_ * tile_cols_ * tile_size_ * tile_size_ *
+                (off_t)sizeof(double);
+  if (ftruncate(fd_, bytes) != 0) {
+    close(fd_);
+    throw std::runtime_error("Cannot allocate the matrix file " + path);
+  }
+}
+
+S21TiledMatrix::S21TiledMatrix(const std::string &path, const S21Matrix &other,
+                               int tile_size, int cache_tiles)
+    : S21TiledMatrix(path, other.GetRows(), other.GetCols(), tile_size,
+                     cache_tiles) {
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      double *tile = Tile(ti, tj, true);
+      int row_end = std::min(tile_size_, rows_ - ti * tile_size_);
+      int col_end = std::min(tile_size_, cols_ - tj * tile_size_);
+      for (int r = 0; r < row_end; ++r) {
+        for (int c = 0; c < col_end; ++c) {
+          tile[r * tile_size_ + c] =
+              other(ti * tile_size_ + r, tj * tile_size_ + c);
+        }
+      }
+    }
+  }
+}
+
+S21TiledMatrix::S21TiledMatrix(S21TiledMatrix &&other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      tile_size_(other.tile_size_),
+      cache_tiles_(other.cache_tiles_),
+      tile_rows_(other.tile_rows_),
+      tile_cols_(other.tile_cols_),
+      fd_(other.fd_),
+      cache_(std::move(other.cache_)),
+      lookup_(std::move(other.lookup_)) {
+  other.fd_ = -1;
+  other.cache_.clear();
+  other.lookup_.clear();
+}
+
+S21TiledMatrix::~S21TiledMatrix() {
+  if (fd_ >= 0) {
+    try {
+      Flush();
+    } catch (const std::exception &) {
+    }
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+double &S21TiledMatrix::operator()(int row, int col) {
+  if (row >= rows_ || col >= cols_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  double *tile = Tile(row / tile_size_, col / tile_size_, true);
+  return tile[(row % tile_size_) * tile_size_ + col % tile_size_];
+}
+
+double S21TiledMatrix::operator()(int row, int col) const {
+  if (row >= rows_ || col >= cols_ || col < 0 || row < 0) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  const double *tile = Tile(row / tile_size_, col / tile_size_, false);
+  return tile[(row % tile_size_) * tile_size_ + col % tile_size_];
+}
+
+S21Matrix S21TiledMatrix::ToMatrix() const {
+  S21Matrix result(rows_, cols_);
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      const double *tile = Tile(ti, tj, false);
+      int row_end = std::min(tile_size_, rows_ - ti * tile_size_);
+      int col_end = std::min(tile_size_, cols_ - tj * tile_size_);
+      for (int r = 0; r < row_end; ++r) {
+        for (int c = 0; c < col_end; ++c) {
+          result(ti * tile_size_ + r, tj * tile_size_ + c) =
+              tile[r * tile_size_ + c];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+double *S21TiledMatrix::Tile(int tile_row, int tile_col, bool write) const {
+  int index = tile_row * tile_cols_ + tile_col;
+  auto found = lookup_.find(index);
+  if (found != lookup_.end()) {
+    cache_.splice(cache_.begin(), cache_, found->second);
+  } else {
+    while ((int)cache_.size() >= cache_tiles_) {
+      WriteBack(cache_.back());
+      lookup_.erase(cache_.back().index);
+      cache_.pop_back();
+    }
+    size_t count = (size_t)tile_size_ * tile_size_;
+    cache_.push_front(CachedTile{index, false, std::vector<double>(count)});
+    lookup_[index] = cache_.begin();
+    char *buffer = reinterpret_cast<char *>(cache_.front().data.data());
+    size_t bytes = count * sizeof(double), done = 0;
+    off_t offset = (off_t)index * (off_t)bytes;
+    while (done < bytes) {
+      ssize_t got = pread(fd_, buffer + done, bytes - done, offset + done);
+      if (got <= 0) {
+        throw std::runtime_error("Cannot read a matrix tile");
+      }
+      done += got;
+    }
+  }
+  cache_.front().dirty = cache_.front().dirty || write;
+  return cache_.front().data.data();
+}
+
+void S21TiledMatrix::WriteBack(const CachedTile &tile) const {
+  if (!tile.dirty) return;
+  const char *buffer = reinterpret_cast<const char *>(tile.data.data());
+  size_t bytes = tile.data.size() * sizeof(double), done = 0;
+  off_t offset = (off_t)tile.index * (off_t)bytes;
+  while (done < bytes) {
+    ssize_t put = pwrite(fd_, buffer + done, bytes - done, offset + done);
+    if (put <= 0) {
+      throw std::runtime_error("Cannot write a matrix tile");
+    }
+    done += put;
+  }
+}
+
+// Asks the kernel to start reading a tile that is about to be used, so the
+// disk works while the current tile is being computed on. Only Linux is
+// relied on to have posix_fadvise; elsewhere tiles are read on demand.
+void S21TiledMatrix::Prefetch(int tile_row, int tile_col) const {
+#ifdef __linux__
+  if (tile_row < 0 || tile_col < 0 || tile_row >= tile_rows_ ||
+      tile_col >= tile_cols_) {
+    return;
+  }
+  int index = tile_row * tile_cols_ + tile_col;
+  if (lookup_.count(index)) return;
+  off_t bytes = (off_t)tile_size_ * tile_size_ * (off_t)sizeof(double);
+  posix_fadvise(fd_, index * bytes, bytes, POSIX_FADV_WILLNEED);
+#else
+  (void)tile_row;
+  (void)tile_col;
+#endif
+}
+
+void S21TiledMatrix::Flush() const {
+  for (CachedTile &tile : cache_) {
+    WriteBack(tile);
+    tile.dirty = false;
+  }
+}
+
+void S21TiledMatrix::CheckSameLayout(const S21TiledMatrix &other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::out_of_range(
+        "Incorrect input, matrices should have the same size");
+  }
+  if (tile_size_ != other.tile_size_) {
+    throw std::invalid_argument(
+        "Incorrect input, matrices should have the same tile size");
+  }
+}
+
+void S21TiledMatrix::SumMatrix(const S21TiledMatrix &other) {
+  CheckSameLayout(other);
+  size_t count = (size_t)tile_size_ * tile_size_;
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      other.Prefetch(ti, tj + 1);
+      double *tile = Tile(ti, tj, true);
+      const double *other_tile = other.Tile(ti, tj, false);
+      for (size_t s = 0; s < count; ++s) tile[s] += other_tile[s];
+    }
+  }
+}
+
+void S21TiledMatrix::SubMatrix(const S21TiledMatrix &other) {
+  CheckSameLayout(other);
+  size_t count = (size_t)tile_size_ * tile_size_;
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      other.Prefetch(ti, tj + 1);
+      double *tile = Tile(ti, tj, true);
+      const double *other_tile = other.Tile(ti, tj, false);
+      for (size_t s = 0; s < count; ++s) tile[s] -= other_tile[s];
+    }
+  }
+}
+
+void S21TiledMatrix::MulNumber(const double num) {
+  size_t count = (size_t)tile_size_ * tile_size_;
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      Prefetch(ti, tj + 1);
+      double *tile = Tile(ti, tj, true);
+      for (size_t s = 0; s < count; ++s) tile[s] *= num;
+    }
+  }
+}
+
+S21TiledMatrix S21TiledMatrix::MulMatrix(const S21TiledMatrix &other,
+                                         const std::string &path) const {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  }
+  if (tile_size_ != other.tile_size_) {
+    throw std::invalid_argument(
+        "Incorrect input, matrices should have the same tile size");
+  }
+  S21TiledMatrix result(path, rows_, other.cols_, tile_size_, cache_tiles_);
+  int t = tile_size_;
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < other.tile_cols_; ++tj) {
+      double *out = result.Tile(ti, tj, true);
+      for (int tk = 0; tk < tile_cols_; ++tk) {
+        Prefetch(ti, tk + 1);
+        other.Prefetch(tk + 1, tj);
+        const double *left = Tile(ti, tk, false);
+        const double *right = other.Tile(tk, tj, false);
+        for (int r = 0; r < t; ++r) {
+          for (int s = 0; s < t; ++s) {
+            double value = left[r * t + s];
+            for (int c = 0; c < t; ++c) {
+              out[r * t + c] += value * right[s * t + c];
+            }
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+S21TiledMatrix S21TiledMatrix::Transpose(const std::string &path) const {
+  S21TiledMatrix result(path, cols_, rows_, tile_size_, cache_tiles_);
+  int t = tile_size_;
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      Prefetch(ti, tj + 1);
+      const double *tile = Tile(ti, tj, false);
+      double *out = result.Tile(tj, ti, true);
+      for (int r = 0; r < t; ++r) {
+        for (int c = 0; c < t; ++c) {
+          out[c * t + r] = tile[r * t + c];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+void S21TiledMatrix::SwapRows(int row1, int row2, int tile_col) {
+  double *first = Tile(row1 / tile_size_, tile_col, true);
+  double *second = Tile(row2 / tile_size_, tile_col, true);
+  std::swap_ranges(first + (row1 % tile_size_) * tile_size_,
+                   first + (row1 % tile_size_ + 1) * tile_size_,
+                   second + (row2 % tile_size_) * tile_size_);
+}
+
+// Right-looking blocked LU with partial pivoting, in place: L (unit diagonal,
+// not stored) below and U on and above the diagonal. One tile column is
+// factored column by column through the cache, its row swaps are applied to
+// the other tile columns, then the U row and the trailing tiles are updated.
+// Returns the pivot rows in LAPACK order: row i was swapped with row
+// pivots[i].
+std::vector<int> S21TiledMatrix::DecomposeLU() {
+  if (rows_ != cols_) {
+    throw std::invalid_argument("The matrix is not square");
+  }
+  int n = rows_, t = tile_size_;
+  std::vector<int> pivots(n);
+  std::vector<double> pivot_row(t);
+  for (int tk = 0; tk < tile_rows_; ++tk) {
+    int first = tk * t, width = std::min(t, n - first);
+    for (int j = 0; j < width; ++j) {
+      int pivot = first + j;
+      double largest = -1.0;
+      for (int ti = tk; ti < tile_rows_; ++ti) {
+        const double *tile = Tile(ti, tk, false);
+        int row_end = std::min(t, n - ti * t);
+        for (int r = ti == tk ? j : 0; r < row_end; ++r) {
+          if (fabs(tile[r * t + j]) > largest) {
+            largest = fabs(tile[r * t + j]);
+            pivot = ti * t + r;
+          }
+        }
+      }
+      pivots[first + j] = pivot;
+      if (largest == 0.0) {
+        throw std::invalid_argument("Matrix determinant is 0");
+      }
+      if (pivot != first + j) SwapRows(first + j, pivot, tk);
+      const double *diagonal = Tile(tk, tk, false);
+      std::copy(diagonal + j * t, diagonal + (j + 1) * t, pivot_row.begin());
+
+      for (int ti = tk; ti < tile_rows_; ++ti) {
+        double *tile = Tile(ti, tk, true);
+        int row_end = std::min(t, n - ti * t);
+        for (int r = ti == tk ? j + 1 : 0; r < row_end; ++r) {
+          double factor = tile[r * t + j] /= pivot_row[j];
+          for (int c = j + 1; c < width; ++c) {
+            tile[r * t + c] -= factor * pivot_row[c];
+          }
+        }
+      }
+    }
+
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      if (tj == tk) continue;
+      for (int j = 0; j < width; ++j) {
+        if (pivots[first + j] != first + j) {
+          SwapRows(first + j, pivots[first + j], tj);
+        }
+      }
+    }
+
+    for (int tj = tk + 1; tj < tile_cols_; ++tj) {
+      double *tile = Tile(tk, tj, true);
+      const double *diagonal = Tile(tk, tk, false);
+      for (int r = 1; r < width; ++r) {
+        for (int q = 0; q < r; ++q) {
+          double factor = diagonal[r * t + q];
+          for (int c = 0; c < t; ++c) {
+            tile[r * t + c] -= factor * tile[q * t + c];
+          }
+        }
+      }
+    }
+    for (int ti = tk + 1; ti < tile_rows_; ++ti) {
+      for (int tj = tk + 1; tj < tile_cols_; ++tj) {
+        Prefetch(tk, tj + 1);
+        double *out = Tile(ti, tj, true);
+        const double *left = Tile(ti, tk, false);
+        const double *up = Tile(tk, tj, false);
+        for (int r = 0; r < t; ++r) {
+          for (int s = 0; s < width; ++s) {
+            double value = left[r * t + s];
+            for (int c = 0; c < t; ++c) {
+              out[r * t + c] -= value * up[s * t + c];
+            }
+          }
+        }
+      }
+    }
+  }
+  return pivots;
+}
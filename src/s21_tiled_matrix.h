@@ -0,0 +1,70 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_TILED_MATRIX_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_TILED_MATRIX_H_
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Matrix kept in a local file as square tile_size x tile_size tiles, tile by
+// tile in row-major tile order. At most `cache_tiles` tiles are resident; the
+// least recently used one is written back and dropped when another is needed.
+// Operations walk whole tiles, so each tile of an operand is read O(n / tile)
+// times, and DecomposeLU needs no memory beyond the cache either: a tile
+// column that does not fit is reread for each of its columns while it is
+// factored. The file is created (or truncated) by the constructor and kept
+// after destruction. References from operator() stay valid only until the next
+// access to the same matrix.
+class S21TiledMatrix {
+ public:
+  S21TiledMatrix(const std::string& path, int rows, int cols, int tile_size,
+                 int cache_tiles);
+  S21TiledMatrix(const std::string& path, const S21Matrix& other,
+                 int tile_size, int cache_tiles);
+  S21TiledMatrix(const S21TiledMatrix& other) = delete;
+  S21TiledMatrix(S21TiledMatrix&& other) noexcept;
+  ~S21TiledMatrix();
+
+  S21TiledMatrix& operator=(const S21TiledMatrix& other) = delete;
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  int GetRows() const { return rows_; };
+  int GetCols() const { return cols_; };
+  int GetTileSize() const { return tile_size_; };
+  S21Matrix ToMatrix() const;
+
+  void SumMatrix(const S21TiledMatrix& other);
+  void SubMatrix(const S21TiledMatrix& other);
+  void MulNumber(const double num);
+  S21TiledMatrix MulMatrix(const S21TiledMatrix& other,
+                           const std::string& path) const;
+  S21TiledMatrix Transpose(const std::string& path) const;
+  std::vector<int> DecomposeLU();
+
+  void Prefetch(int tile_row, int tile_col) const;
+  void Flush() const;
+
+ private:
+  struct CachedTile {
+    int index;
+    bool dirty;
+    std::vector<double> data;
+  };
+
+  int rows_, cols_, tile_size_, cache_tiles_;
+  int tile_rows_, tile_cols_;
+  int fd_;
+  mutable std::list<CachedTile> cache_;
+  mutable std::unordered_map<int, std::list<CachedTile>::iterator> lookup_;
+
+  double* Tile(int tile_row, int tile_col, bool write) const;
+  void WriteBack(const CachedTile& tile) const;
+  void CheckSameLayout(const S21TiledMatrix& other) const;
+  void SwapRows(int row1, int row2, int tile_col);
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_TILED_MATRIX_H_
@@ -0,0 +1,78 @@
+#include "s21_vector.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "s21_kernels.h"
+
+S21Vector::S21Vector() : data_(1, 0.0) {}
+
+S21Vector::S21Vector(int size) {
+  if (size < 1) {
+    throw std::out_of_range("Incorrect input, vectors should have elements");
+  }
+  data_.assign(size, 0.0);
+}
+
+S21Vector::S21Vector(const S21Matrix &matrix) {
+  if (matrix.GetRows() != 1 && matrix.GetCols() != 1) {
+    throw std::invalid_argument("The matrix is not a row or a column");
+  }
+  bool column = matrix.GetCols() == 1;
+  data_.resize(column ? matrix.GetRows() : matrix.GetCols());
+  for (size_t i = 0; i < data_.size(); ++i) {
+    data_[i] = column ? matrix(i, 0) : matrix(0, i);
+  }
+}
+
+double &S21Vector::operator()(int index) {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return data_[index];
+}
+
+double S21Vector::operator()(int index) const {
+  if (index < 0 || index >= GetSize()) {
+    throw std::out_of_range("Incorrect input, index is out of range ");
+  }
+  return data_[index];
+}
+
+bool S21Vector::operator==(const S21Vector &other) const {
+  return EqVector(other);
+}
+
+S21Matrix S21Vector::ToMatrix() const {
+  S21Matrix result(GetSize(), 1);
+  for (size_t i = 0; i < data_.size(); ++i) result(i, 0) = data_[i];
+  return result;
+}
+
+bool S21Vector::EqVector(const S21Vector &other) const {
+  if (data_.size() != other.data_.size()) return false;
+  for (size_t i = 0; i < data_.size(); ++i) {
+    if (fabs(data_[i] - other.data_[i]) > eps) return false;
+  }
+  return true;
+}
+
+void S21Vector::MulNumber(const double num) {
+  for (double &value : data_) value *= num;
+}
+
+void S21Vector::Axpy(double alpha, const S21Vector &x) {
+  if (x.data_.size() != data_.size()) {
+    throw std::out_of_range(
+        "Incorrect input, vectors should have the same size");
+  }
+  S21Axpy(alpha, x.data_.data(), data_.data(), data_.size());
+}
+
+double S21Vector::Dot(const S21Vector &other) const {
+  if (other.data_.size() != data_.size()) {
+    throw std::out_of_range(
+        "Incorrect input, vectors should have the same size");
+  }
+  return S21Dot(data_.data(), other.data_.data(), data_.size());
+}
@@ -0,0 +1,43 @@
+#ifndef CPP_S21_MATRIX_PLUS_SRC_S21_VECTOR_H_
+#define CPP_S21_MATRIX_PLUS_SRC_S21_VECTOR_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Dense vector for the matrix-vector kernels of S21Matrix (MulVector,
+// MulVectorTransposed, RankOneUpdate). Converts to and from n x 1 or 1 x n
+// matrices.
+class S21Vector {
+ public:
+  S21Vector();
+  explicit S21Vector(int size);
+  explicit S21Vector(const S21Matrix& matrix);
+
+  double& operator()(int index);
+  double operator()(int index) const;
+  bool operator==(const S21Vector& other) const;
+
+  int GetSize() const { return (int)data_.size(); };
+  double* Data() { return data_.data(); };
+  const double* Data() const { return data_.data(); };
+  S21Matrix ToMatrix() const;
+
+  bool EqVector(const S21Vector& other) const;
+  void MulNumber(const double num);
+  // this += alpha * x
+  void Axpy(double alpha, const S21Vector& x);
+  double Dot(const S21Vector& other) const;
+
+ private:
+  std::vector<double> data_;
+};
+
+// Result of S21Matrix::Statistics; the variance is the population one,
+// divided by the number of elements.
+struct S21Statistics {
+  S21Vector mean;
+  S21Vector variance;
+};
+
+#endif  // CPP_S21_MATRIX_PLUS_SRC_S21_VECTOR_H_